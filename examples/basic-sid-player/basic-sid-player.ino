@@ -28,13 +28,10 @@ correctly by following the instructions for that library.
 AudioKit kit;
 AudioActions actions;
 
-SID sid;
+SID6581 sid;
 SidRegPlayer player(&sid);
 SidRegPlayerConfig sid_cfg;
 
-char buffer[25];
-char oldbuffer[25];
-
 const int BUFFER_SIZE = 4 * 882;  // needs to be at least (2 CH * 2 BYTES * SAMPLERATE/PAL_CLOCK). Ex. 4 * (44100/50)
 uint8_t audiobuffer[BUFFER_SIZE];
 
@@ -51,8 +48,6 @@ void setup() {
   player.setDefaultConfig(&sid_cfg);
   sid_cfg.samplerate = cfg.sampleRate();
   player.begin(&sid_cfg);
-  memset(buffer,0,sizeof(buffer));
-  memset(oldbuffer,0,sizeof(oldbuffer));  
 }
 
 void loop() {
@@ -63,14 +58,8 @@ void loop() {
   m = micros();
 
   // update the total of 25 sid registers, every raster line time (50Hz for PAL)
-  for(int i=0;i<25;i++) {
-    buffer[i] = Comic_Bakery[song_idx];
-    if(buffer[i] != oldbuffer[i]) {
-      player.setreg(i, buffer[i]);
-      oldbuffer[i] = buffer[i];                  
-    }
-    ++song_idx;
-  }
+  player.setregs(&Comic_Bakery[song_idx]);
+  song_idx += 25;
 
   if (song_idx >= Comic_Bakery_len)
     song_idx = 0;
@@ -0,0 +1,550 @@
+/*
+Render benchmark for the ReSID engine.
+A synthetic register stream (pulse arpeggio, filtered sawtooth sweep and a triangle bass line) is written to the
+sid emulator once per PAL frame, and the time needed to render the audio for those frames is measured.
+No audio output is needed, the results are printed on the serial port as samples per second and as a
+realtime factor, ie how many times faster than realtime the engine renders at the given sample rate.
+
+The following render paths are compared:
+  - per sample: sid.clock(delta_t) + sid.output() for each sample, delta_t truncated to whole cycles
+  - block:      sid.clock(cycles, buffer, n), 16.16 fixed point cycles per sample, for each sampling method
+  - scope:      the block path filling per voice buffers for a scope display next to the output
+  - mixer:      1, 2 and 3 chips clocked in lockstep by SidMixer and mixed to stereo, with and without
+                voice panning
+  - idle:       the block path rendering silence after all voices have been released
+  - 6502:       a small corpus of playroutines run by the cpu core, as instructions per second, and the
+                opcode pairs the corpus executes most, the candidates for fused handlers in the core
+  - load:       SidPlayer::load() of a generated tune, used in place from memory, copied from memory and
+                on a desktop host read from a file
+
+When comic.h from the basic-sid-player example is copied into this sketch folder, the Comic_Bakery register
+dump is rendered as well, at several sample rates. Build the sketch once as is and once with
+#define RESID_SKIP_AHEAD 0 above the SidTools.h include to compare skip-ahead clocking to the stepped loop.
+
+The sketch has no hardware dependencies besides a serial port, so it runs on ESP32 and STM32 boards alike.
+
+10/17/2026 beachviking
+*/
+
+#include <SidTools.h>
+
+#if __has_include("comic.h")
+#include "comic.h"
+#define HAVE_COMIC_BAKERY 1
+#endif
+
+const int SAMPLERATE = 44100;
+const int CLOCKFREQ = 985248;
+const int FRAMES = 500;                 // 10 seconds of PAL frames
+const int FRAME_CYCLES = CLOCKFREQ / 50;
+
+SID6581 sid;
+SID6581 sid2, sid3;
+short samples[SAMPLERATE / 50 + 1];
+short stereo[2 * (SAMPLERATE / 50 + 1)];
+
+// Fill the 25 sid registers for a given frame of the synthetic tune.
+void frameRegisters(int frame, uint8_t *regs) {
+  static const uint16_t notes[] = { 0x1167, 0x1389, 0x15ed, 0x1a13 };
+  uint16_t lead = notes[frame % 4];
+  uint16_t bass = notes[(frame / 16) % 4] >> 2;
+  uint16_t cutoff = (frame * 8) & 0x7ff;
+
+  memset(regs, 0, 25);
+  // voice 1, pulse arpeggio
+  regs[0x00] = lead & 0xff; regs[0x01] = lead >> 8;
+  regs[0x02] = 0x00; regs[0x03] = 0x08;
+  regs[0x04] = 0x41; regs[0x05] = 0x09; regs[0x06] = 0xa0;
+  // voice 2, sawtooth through the filter, retriggered every 8 frames
+  regs[0x07] = (lead >> 1) & 0xff; regs[0x08] = lead >> 9;
+  regs[0x0b] = (frame & 7) ? 0x21 : 0x20; regs[0x0c] = 0x22; regs[0x0d] = 0x84;
+  // voice 3, triangle bass
+  regs[0x0e] = bass & 0xff; regs[0x0f] = bass >> 8;
+  regs[0x12] = 0x11; regs[0x13] = 0x00; regs[0x14] = 0xf0;
+  // filter, lowpass sweep with some resonance on voice 2
+  regs[0x15] = cutoff & 0x07; regs[0x16] = cutoff >> 3;
+  regs[0x17] = 0x82; regs[0x18] = 0x1f;
+}
+
+void writeFrame(int frame, SID *chip = &sid) {
+  uint8_t regs[25];
+  frameRegisters(frame, regs);
+  chip->write_block(regs);
+}
+
+void report(const char *name, long samples, unsigned long us) {
+  float rate = samples * 1000000.0 / us;
+  printf("%-14s %8ld samples %8lu us %10.0f samples/s %6.2fx realtime\n", name, samples, us, rate, rate / SAMPLERATE);
+}
+
+void benchPerSample() {
+  cycle_count delta_t = CLOCKFREQ / SAMPLERATE;
+  int samples_per_frame = SAMPLERATE / 50;
+  long total = 0;
+  volatile int sink = 0;
+
+  sid.reset();
+  sid.set_sampling_parameters(CLOCKFREQ, SAMPLE_FAST, SAMPLERATE);
+  unsigned long start = micros();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    writeFrame(frame);
+    for (int j = 0; j < samples_per_frame; j++) {
+      sid.clock(delta_t);
+      sink += sid.output();
+    }
+    total += samples_per_frame;
+  }
+  report("per sample", total, micros() - start);
+}
+
+void benchBlock(const char *name, sampling_method method) {
+  long total = 0;
+
+  sid.reset();
+  sid.set_sampling_parameters(CLOCKFREQ, method, SAMPLERATE);
+  unsigned long start = micros();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    writeFrame(frame);
+    cycle_count cycles = FRAME_CYCLES;
+    total += sid.clock(cycles, samples, sizeof(samples) / sizeof(samples[0]));
+  }
+  report(name, total, micros() - start);
+}
+
+// Render with the three voices captured for a scope display, every 4th sample.
+void benchScope(const char *name, sampling_method method) {
+  static short scope[3][(SAMPLERATE / 50 + 1) / 4 + 1];
+  VoiceCapture capture;
+  long total = 0;
+
+  for (int i = 0; i < 3; i++)
+    capture.buf[i] = scope[i];
+  capture.size = sizeof(scope[0]) / sizeof(scope[0][0]);
+  capture.decimation = 4;
+
+  sid.reset();
+  sid.set_sampling_parameters(CLOCKFREQ, method, SAMPLERATE);
+  sid.set_voice_capture(&capture);
+  unsigned long start = micros();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    writeFrame(frame);
+    capture.length = 0;
+    cycle_count cycles = FRAME_CYCLES;
+    total += sid.clock(cycles, samples, sizeof(samples) / sizeof(samples[0]));
+  }
+  report(name, total, micros() - start);
+  sid.set_voice_capture(0);
+}
+
+// Render the synthetic tune on 1 to 3 chips through the block mixer to stereo, as for 2SID and 3SID tunes.
+// The extra chips run a few frames behind, so they do not render the same data. With panned set,
+// voice 1 of each chip is panned left and voice 3 right, which adds the side channel to the mix.
+void benchMixer(const char *name, int chips, bool panned = false) {
+  SID *all[] = { &sid, &sid2, &sid3 };
+  SidMixer mixer;
+  long total = 0;
+
+  for (int i = 0; i < chips; i++) {
+    all[i]->reset();
+    all[i]->set_sampling_parameters(CLOCKFREQ, SAMPLE_FAST, SAMPLERATE);
+    all[i]->set_voice_pan(0, panned ? -16384 : 0);
+    all[i]->set_voice_pan(2, panned ? 16384 : 0);
+    mixer.add(all[i]);
+  }
+  unsigned long start = micros();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < chips; i++)
+      writeFrame(frame + 3 * i, all[i]);
+    total += mixer.readStereo(FRAME_CYCLES, stereo, SAMPLERATE / 50 + 1);
+  }
+  report(name, total, micros() - start);
+}
+
+// Render silence after the synthetic tune has been released, as between tunes or in the player menu.
+// Once the envelopes have reached zero and the filters have settled, the engine idles until the next
+// register write.
+void benchIdle(const char *name, sampling_method method) {
+  long total = 0;
+
+  sid.reset();
+  sid.set_sampling_parameters(CLOCKFREQ, method, SAMPLERATE);
+  for (int frame = 0; frame < 50; frame++) {
+    writeFrame(frame);
+    cycle_count cycles = FRAME_CYCLES;
+    sid.clock(cycles, samples, sizeof(samples) / sizeof(samples[0]));
+  }
+  sid.write(0x04, 0x40);
+  sid.write(0x0b, 0x20);
+  sid.write(0x12, 0x10);
+
+  unsigned long start = micros();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    cycle_count cycles = FRAME_CYCLES;
+    total += sid.clock(cycles, samples, sizeof(samples) / sizeof(samples[0]));
+  }
+  report(name, total, micros() - start);
+}
+
+// A small corpus of playroutine kernels, loaded at $1000 and called once per frame until their RTS.
+struct Playroutine {
+  const char *name;
+  const uint8_t *code;
+  int length;
+};
+
+// Copy the 25 shadow registers at $1100 to the sid
+const uint8_t regcopy[] = {
+  0xa2, 0x18,             //       ldx #$18
+  0xbd, 0x00, 0x11,       // loop: lda $1100,x
+  0x9d, 0x00, 0xd4,       //       sta $d400,x
+  0xca,                   //       dex
+  0x10, 0xf7,             //       bpl loop
+  0x60                    //       rts
+};
+
+// 16 bit frequency slides of three voices, eight effect passes, then write the frequencies
+const uint8_t slides[] = {
+  0xa0, 0x07,             //        ldy #$07
+  0xa2, 0x02,             // pass:  ldx #$02
+  0x18,                   // voice: clc
+  0xb5, 0x20,             //        lda $20,x
+  0x75, 0x30,             //        adc $30,x
+  0x95, 0x20,             //        sta $20,x
+  0xb5, 0x23,             //        lda $23,x
+  0x75, 0x33,             //        adc $33,x
+  0x95, 0x23,             //        sta $23,x
+  0xca,                   //        dex
+  0x10, 0xf0,             //        bpl voice
+  0x88,                   //        dey
+  0x10, 0xeb,             //        bpl pass
+  0xa5, 0x20,             //        lda $20
+  0x8d, 0x00, 0xd4,       //        sta $d400
+  0xa5, 0x23,             //        lda $23
+  0x8d, 0x01, 0xd4,       //        sta $d401
+  0xa5, 0x21,             //        lda $21
+  0x8d, 0x07, 0xd4,       //        sta $d407
+  0xa5, 0x24,             //        lda $24
+  0x8d, 0x08, 0xd4,       //        sta $d408
+  0x60                    //        rts
+};
+
+// Pattern sequencer, a subroutine per voice reads the pattern at ($70),y and sets the control register
+const uint8_t sequencer[] = {
+  0xa2, 0x00,             //        ldx #$00
+  0x86, 0x50,             // voice: stx $50
+  0x20, 0x0f, 0x10,       //        jsr step
+  0xa6, 0x50,             //        ldx $50
+  0xe8,                   //        inx
+  0xe0, 0x03,             //        cpx #$03
+  0xd0, 0xf4,             //        bne voice
+  0x60,                   //        rts
+  0xb5, 0x60,             // step:  lda $60,x
+  0xa8,                   //        tay
+  0xb1, 0x70,             //        lda ($70),y
+  0xc9, 0x80,             //        cmp #$80
+  0x90, 0x04,             //        bcc gate
+  0x29, 0x7f,             //        and #$7f
+  0x49, 0x55,             //        eor #$55
+  0xbc, 0x10, 0x11,       // gate:  ldy $1110,x
+  0x99, 0x04, 0xd4,       //        sta $d404,y
+  0xf6, 0x60,             //        inc $60,x
+  0xb5, 0x60,             //        lda $60,x
+  0x29, 0x3f,             //        and #$3f
+  0x95, 0x60,             //        sta $60,x
+  0x0a,                   //        asl
+  0x26, 0x80,             //        rol $80
+  0x60                    //        rts
+};
+
+// Self-modifying code as common in players: the voice loop patches the address of its sid store and
+// the immediate operand of its add
+const uint8_t selfmod[] = {
+  0xa2, 0x02,             // voice: ldx #$02
+  0xbd, 0x10, 0x11,       //        lda $1110,x
+  0x8d, 0x0d, 0x10,       //        sta store+1
+  0xb5, 0x20,             //        lda $20,x
+  0x69, 0x10,             // add:   adc #$10
+  0x8d, 0x00, 0xd4,       // store: sta $d400
+  0x8d, 0x0b, 0x10,       //        sta add+1
+  0x95, 0x20,             //        sta $20,x
+  0xca,                   //        dex
+  0x10, 0xeb,             //        bpl voice
+  0x60                    //        rts
+};
+
+// Typical driver idioms: pattern bytes read with lda ($70),y / iny, register values from tables with
+// lda abs,y / sta $d4xx, and a delay counter with dec zp / bne
+const uint8_t driver[] = {
+  0xa0, 0x00,             //        ldy #$00
+  0xb1, 0x70,             //        lda ($70),y
+  0xc8,                   //        iny
+  0x85, 0x42,             //        sta $42
+  0xb1, 0x70,             //        lda ($70),y
+  0xc8,                   //        iny
+  0x85, 0x43,             //        sta $43
+  0xa4, 0x42,             //        ldy $42
+  0xb9, 0x00, 0x11,       //        lda $1100,y
+  0x8d, 0x00, 0xd4,       //        sta $d400
+  0xb9, 0x01, 0x11,       //        lda $1101,y
+  0x8d, 0x01, 0xd4,       //        sta $d401
+  0xb9, 0x02, 0x11,       //        lda $1102,y
+  0x8d, 0x02, 0xd4,       //        sta $d402
+  0xb9, 0x03, 0x11,       //        lda $1103,y
+  0x8d, 0x03, 0xd4,       //        sta $d403
+  0xa2, 0x05,             //        ldx #$05
+  0xa9, 0x08,             // delay: lda #$08
+  0x85, 0x44,             //        sta $44
+  0xc6, 0x44,             // wait:  dec $44
+  0xd0, 0xfc,             //        bne wait
+  0xca,                   //        dex
+  0xd0, 0xf5,             //        bne delay
+  0x60                    //        rts
+};
+
+const Playroutine corpus[] = {
+  { "6502 regcopy", regcopy, sizeof(regcopy) },
+  { "6502 slides", slides, sizeof(slides) },
+  { "6502 sequencer", sequencer, sizeof(sequencer) },
+  { "6502 selfmod", selfmod, sizeof(selfmod) },
+  { "6502 driver", driver, sizeof(driver) },
+};
+
+Cpu6502 cpu;
+
+#ifdef MOS6502_PAGED_MEMORY
+// With paged memory the 64K buffer is mapped read only, the pages the routines store to are copied here
+uint8_t page_pool[16 << 8];
+
+uint8_t cpuRead(uint16_t address) { return cpu.pages[address >> 8][address & 0xff]; }
+#else
+uint8_t cpuRead(uint16_t address) { return cpu.mem[address]; }
+#endif
+
+// Load a playroutine of the corpus with the tables and zero page values it uses
+void loadRoutine(uint8_t *mem, const Playroutine &routine) {
+  memset(mem, 0, 0x10000);
+  memcpy(&mem[0x1000], routine.code, routine.length);
+  for (int i = 0; i < 25; i++)
+    mem[0x1100 + i] = i * 11;
+  mem[0x1110] = 0; mem[0x1111] = 7; mem[0x1112] = 14;
+  mem[0x30] = 0x21; mem[0x31] = 0x13; mem[0x32] = 0xe1;
+  mem[0x70] = 0x00; mem[0x71] = 0x12;
+  for (int i = 0; i < 64; i++)
+    mem[0x1200 + i] = i * 37;
+#ifdef MOS6502_PAGED_MEMORY
+  initpages(&cpu, page_pool, sizeof(page_pool) >> 8);
+  mapimage(&cpu, mem, 0, 0x10000);
+#else
+  cpu.mem = mem;
+#endif
+}
+
+// Run each playroutine of the corpus for a number of frames with run_until_return(). The instructions
+// per frame are counted once by single stepping the routine with runcpu().
+void benchCpu() {
+  uint8_t *mem = (uint8_t *)malloc(0x10000);
+  if (!mem) {
+    printf("6502: no memory for the cpu\n");
+    return;
+  }
+
+  for (const Playroutine &routine : corpus) {
+    const int calls = FRAMES * 100;
+    long instructions = 0;
+
+    loadRoutine(mem, routine);
+    initcpu(&cpu, 0x1000, 0, 0, 0);
+    while (runcpu(&cpu))
+      instructions++;
+    instructions++;
+
+    unsigned long start = micros();
+    for (int frame = 0; frame < calls; frame++) {
+      initcpu(&cpu, 0x1000, 0, 0, 0);
+      cpu.sidwrite_count = 0;
+      run_until_return(&cpu, 0x100000, 0, 0, 0);
+    }
+    unsigned long us = micros() - start;
+    printf("%-14s %8ld instr %8lu us %10.0f instr/s\n", routine.name, instructions * calls, us,
+           instructions * calls * 1000000.0 / us);
+  }
+  free(mem);
+}
+
+// Count the opcode pairs executed by the corpus over a number of frames, single stepping each routine,
+// and print the most frequent ones with their share of all executed pairs.
+void profilePairs() {
+  struct OpcodePair {
+    uint8_t first, second;
+    long count;
+  };
+  const int MAX_PAIRS = 128;
+  static OpcodePair pairs[MAX_PAIRS];
+  int pair_count = 0;
+  long total = 0;
+
+  uint8_t *mem = (uint8_t *)malloc(0x10000);
+  if (!mem)
+    return;
+
+  for (const Playroutine &routine : corpus) {
+    loadRoutine(mem, routine);
+    for (int frame = 0; frame < 50; frame++) {
+      int previous = -1;
+      initcpu(&cpu, 0x1000, 0, 0, 0);
+      cpu.sidwrite_count = 0;
+      for (;;) {
+        uint8_t op = cpuRead(cpu.pc);
+        if (previous >= 0) {
+          int i = 0;
+          while (i < pair_count && (pairs[i].first != previous || pairs[i].second != op))
+            i++;
+          if (i == pair_count && pair_count < MAX_PAIRS)
+            pairs[pair_count++] = { (uint8_t)previous, op, 0 };
+          if (i < pair_count)
+            pairs[i].count++;
+          total++;
+        }
+        previous = op;
+        if (!runcpu(&cpu))
+          break;
+      }
+    }
+  }
+  free(mem);
+
+  printf("6502 opcode pairs over %ld pairs:", total);
+  for (int n = 0; n < 10 && n < pair_count; n++) {
+    int best = n;
+    for (int i = n + 1; i < pair_count; i++)
+      if (pairs[i].count > pairs[best].count)
+        best = i;
+    OpcodePair top = pairs[best];
+    pairs[best] = pairs[n];
+    pairs[n] = top;
+    printf(" %02x-%02x %.1f%%", top.first, top.second, top.count * 100.0 / total);
+  }
+  printf("\n");
+}
+
+// A memory source that hides its data, so the tune is read and copied like from a file
+class CopiedSidSource : public MemorySidSource {
+public:
+  CopiedSidSource(const uint8_t *data, uint32_t size) : MemorySidSource(data, size) {}
+  const uint8_t *data() { return nullptr; }
+};
+
+void reportLoad(const char *name, SidPlayer &player, SidSource &source, uint32_t size) {
+  const int loads = 100;
+
+  unsigned long start = micros();
+  for (int i = 0; i < loads; i++)
+    player.load(&source, true);
+  unsigned long us = micros() - start;
+  printf("%-14s %8lu bytes %8lu us per load %8.1f MB/s\n", name, (unsigned long)size, us / loads,
+         us ? (float)size * loads / us : 0.0f);
+}
+
+// Time SidPlayer::load() of a PSID with a 32K payload, used in place from memory, copied from memory
+// and, on a POSIX host, read from a file.
+void benchLoad() {
+  const uint32_t payload = 0x8000;
+  const uint32_t size = 0x7c + 2 + payload;
+  uint8_t *file = (uint8_t *)malloc(size);
+  if (!file) {
+    printf("load: no memory for the file\n");
+    return;
+  }
+
+  // PSID v2 header, the load address $1000 in front of the data
+  memset(file, 0, 0x7c);
+  memcpy(file, "PSID", 4);
+  file[0x05] = 2;
+  file[0x07] = 0x7c;
+  file[0x0a] = 0x10; file[0x0c] = 0x10; file[0x0d] = 0x03;
+  file[0x0f] = 1; file[0x11] = 1;
+  file[0x7c] = 0x00; file[0x7d] = 0x10;
+  for (uint32_t i = 0; i < payload; i++)
+    file[0x7e + i] = i * 37;
+  memcpy(&file[0x7e], driver, sizeof(driver));
+
+  SidPlayer *player = new SidPlayer(&sid);
+  MemorySidSource in_place(file, size);
+  CopiedSidSource copied(file, size);
+  reportLoad("load in place", *player, in_place, size);
+  reportLoad("load copied", *player, copied, size);
+
+#ifdef SIDSOURCE_POSIX
+  const char *path = "/tmp/sid-benchmark.sid";
+  FILE *out = fopen(path, "wb");
+  if (out && fwrite(file, 1, size, out) == size) {
+    fclose(out);
+    PosixSidSource posix(path);
+    reportLoad("load posix", *player, posix, size);
+    unlink(path);
+  } else if (out) {
+    fclose(out);
+  }
+#endif
+
+  delete player;
+  free(file);
+}
+
+#ifdef HAVE_COMIC_BAKERY
+void benchComicBakery(int samplerate, sampling_method method) {
+  static short buffer[96000 / 50 + 1];
+  char name[24];
+  long total = 0;
+
+  sid.reset();
+  sid.set_sampling_parameters(CLOCKFREQ, method, samplerate);
+  unsigned long start = micros();
+  for (long idx = 0; idx + 25 <= Comic_Bakery_len; idx += 25) {
+    sid.write_block(&Comic_Bakery[idx]);
+    cycle_count cycles = FRAME_CYCLES;
+    total += sid.clock(cycles, buffer, samplerate / 50 + 1);
+  }
+  unsigned long us = micros() - start;
+
+  // Realtime factor relative to the sample rate of this run.
+  float rate = total * 1000000.0 / us;
+  snprintf(name, sizeof(name), "comic %d", samplerate);
+  printf("%-14s %8ld samples %8lu us %10.0f samples/s %6.2fx realtime%s\n", name, total, us, rate,
+         rate / samplerate, method == SAMPLE_FAST ? "" : " (resample)");
+}
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  printf("SID render benchmark, %d Hz, %d frames, skip-ahead %s\n", SAMPLERATE, FRAMES,
+         RESID_SKIP_AHEAD ? "on" : "off");
+  benchPerSample();
+  benchBlock("fast", SAMPLE_FAST);
+  benchBlock("interpolate", SAMPLE_INTERPOLATE);
+  benchBlock("resample", SAMPLE_RESAMPLE_FAST);
+  benchBlock("resample int", SAMPLE_RESAMPLE_INTERPOLATE);
+  benchScope("fast scope", SAMPLE_FAST);
+  benchScope("resample scope", SAMPLE_RESAMPLE_FAST);
+  benchMixer("1sid stereo", 1);
+  benchMixer("2sid stereo", 2);
+  benchMixer("3sid stereo", 3);
+  benchMixer("3sid panned", 3, true);
+  benchIdle("fast idle", SAMPLE_FAST);
+  benchIdle("resample idle", SAMPLE_RESAMPLE_FAST);
+  benchCpu();
+  profilePairs();
+  benchLoad();
+
+#ifdef HAVE_COMIC_BAKERY
+  benchComicBakery(22050, SAMPLE_FAST);
+  benchComicBakery(44100, SAMPLE_FAST);
+  benchComicBakery(96000, SAMPLE_FAST);
+  benchComicBakery(44100, SAMPLE_RESAMPLE_FAST);
+#endif
+}
+
+void loop() {
+}
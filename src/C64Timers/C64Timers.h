@@ -0,0 +1,238 @@
+#pragma once
+
+#include "SidTools.h"
+
+// Timers A and B of both CIAs and the raster interrupt of the VIC, clocked over whole spans of
+// cpu cycles instead of cycle by cycle. The player runs the cpu from one interrupt to the next,
+// replays the queued register writes at their cycles and asks for the time to the next interrupt.
+// Between runs the counters, the raster line and the interrupt flags are copied into the memory
+// image, so code polling them sees them move on from one run to the next.
+// Timer B only counts cpu cycles, set to count timer A underflows or CNT it stays stopped. The
+// interrupt flags are cleared when they are copied to memory rather than when they are read.
+class C64Timers
+{
+public:
+	static const uint32_t NEVER = 0xffffffff;
+
+	enum { IRQ = 1, NMI = 2 };			// CIA 1 and the VIC raise IRQs, CIA 2 raises NMIs
+
+	C64Timers() { reset(63, 312, 0x4025); }
+
+	// The state the Kernal leaves behind: timer A of CIA 1 running from latch with its interrupt
+	// enabled, the other timers stopped and the raster interrupt off
+	void reset(int line_cycles, int lines, uint16_t latch);
+
+	// Apply a register write at the current time, $D000-$D3FF goes to the VIC and $DC00-$DDFF to the CIAs
+	void write(uint16_t address, uint8_t value);
+
+	// Move on by cycles, the interrupts raised on the way are pending until take()
+	void advance(uint32_t cycles);
+
+	// Cycles to the next interrupt of the kinds in kinds from an enabled source, NEVER if there is none
+	uint32_t next(int kinds = IRQ | NMI);
+
+	bool raised() { return pending != 0; }
+	int take() { int p = pending; pending = 0; return p; }
+
+	// Copy the counters, the raster line and the interrupt flags into the memory image, given by
+	// its pages at $D000, $DC00 and $DD00
+	void sync(uint8_t *vic, uint8_t *cia1, uint8_t *cia2);
+
+	int getLineCycles() { return line_cycles; }
+	int getLines() { return lines; }
+	uint32_t getFrameCycles() { return frame_cycles; }
+
+	// Whether a queued write goes to a register modeled here
+	static bool handles(uint16_t address) {
+		return (address & 0xfe00) == 0xdc00 ||
+		       ((address & 0xfc00) == 0xd000 && (unsigned)((address & 0x3f) - 0x11) < 10);
+	}
+
+private:
+	struct Timer {
+		uint16_t latch;
+		uint16_t counter;					// underflows counter + 1 cycles from now
+		bool running;
+		bool oneshot;
+	};
+
+	struct Cia {
+		Timer timer[2];
+		uint8_t mask;						// enabled interrupt sources, bit 0 timer A, bit 1 timer B
+		uint8_t flags;						// sources that underflowed
+	};
+
+	Cia cia[2];
+	int line_cycles;
+	int lines;
+	uint32_t frame_cycles;
+	uint32_t raster_cycle;					// position in the frame
+	uint16_t raster_compare;
+	uint8_t raster_mask;					// $D01A
+	uint8_t raster_flags;					// $D019
+	int pending;
+
+	static bool clock(Timer &t, uint32_t cycles);
+	uint32_t untilRaster();
+};
+
+void C64Timers::reset(int line_cycles, int lines, uint16_t latch)
+{
+  this->line_cycles = line_cycles;
+  this->lines = lines;
+  frame_cycles = line_cycles * lines;
+  raster_cycle = 0;
+  raster_compare = 0;
+  raster_mask = 0;
+  raster_flags = 0;
+  pending = 0;
+
+  memset(cia, 0, sizeof(cia));
+  for (int i = 0; i < 2; i++)
+    for (int t = 0; t < 2; t++)
+      cia[i].timer[t].latch = cia[i].timer[t].counter = 0xffff;
+
+  Timer &kernal = cia[0].timer[0];
+  kernal.latch = kernal.counter = latch;
+  kernal.running = true;
+  cia[0].mask = 0x01;
+}
+
+void C64Timers::write(uint16_t address, uint8_t value)
+{
+  if ((address & 0xfc00) == 0xd000) {
+    switch (address & 0x3f) {
+      case 0x11: raster_compare = (raster_compare & 0xff) | ((value & 0x80) << 1); break;
+      case 0x12: raster_compare = (raster_compare & 0x100) | value; break;
+      case 0x1a: raster_mask = value & 0x0f; break;
+    }
+    return;
+  }
+  if ((address & 0xfe00) != 0xdc00)
+    return;
+
+  Cia &c = cia[(address >> 8) & 1];
+  int reg = address & 0x0f;
+
+  switch (reg) {
+    case 0x4: case 0x6: {
+      Timer &t = c.timer[(reg - 4) >> 1];
+      t.latch = (t.latch & 0xff00) | value;
+      break;
+    }
+    case 0x5: case 0x7: {
+      // The counter of a stopped timer is loaded along with the high byte of the latch
+      Timer &t = c.timer[(reg - 4) >> 1];
+      t.latch = (t.latch & 0x00ff) | (value << 8);
+      if (!t.running)
+        t.counter = t.latch;
+      break;
+    }
+    case 0xd:
+      if (value & 0x80)
+        c.mask |= value & 0x1f;
+      else
+        c.mask &= ~value;
+      break;
+    case 0xe: case 0xf: {
+      Timer &t = c.timer[reg - 0xe];
+      t.running = (value & 0x01) && (reg == 0xe || !(value & 0x60));
+      t.oneshot = value & 0x08;
+      if (value & 0x10)
+        t.counter = t.latch;
+      break;
+    }
+  }
+}
+
+// Count a timer down by cycles, returns whether it underflowed on the way
+bool C64Timers::clock(Timer &t, uint32_t cycles)
+{
+  if (!t.running)
+    return false;
+  if (cycles <= t.counter) {
+    t.counter -= cycles;
+    return false;
+  }
+
+  cycles -= t.counter + 1;
+  if (t.oneshot) {
+    t.running = false;
+    t.counter = t.latch;
+  } else {
+    t.counter = t.latch - cycles % ((uint32_t)t.latch + 1);
+  }
+  return true;
+}
+
+// Cycles to the next start of the raster compare line, a whole frame when it starts now
+uint32_t C64Timers::untilRaster()
+{
+  if (raster_compare >= lines)
+    return NEVER;
+
+  uint32_t at = raster_compare * line_cycles;
+  uint32_t until = (at + frame_cycles - raster_cycle) % frame_cycles;
+  return until ? until : frame_cycles;
+}
+
+void C64Timers::advance(uint32_t cycles)
+{
+  for (int i = 0; i < 2; i++) {
+    for (int t = 0; t < 2; t++) {
+      if (clock(cia[i].timer[t], cycles)) {
+        cia[i].flags |= 1 << t;
+        if (cia[i].mask & (1 << t))
+          pending |= i ? NMI : IRQ;
+      }
+    }
+  }
+
+  if (untilRaster() <= cycles) {
+    raster_flags |= 0x01;
+    if (raster_mask & 0x01)
+      pending |= IRQ;
+  }
+  raster_cycle = (raster_cycle + cycles) % frame_cycles;
+}
+
+uint32_t C64Timers::next(int kinds)
+{
+  uint32_t until = NEVER;
+
+  for (int i = 0; i < 2; i++) {
+    if (!(kinds & (i ? NMI : IRQ)))
+      continue;
+    for (int t = 0; t < 2; t++) {
+      const Timer &timer = cia[i].timer[t];
+      if (timer.running && (cia[i].mask & (1 << t)) && timer.counter + 1u < until)
+        until = timer.counter + 1u;
+    }
+  }
+  if ((kinds & IRQ) && (raster_mask & 0x01)) {
+    uint32_t raster = untilRaster();
+    if (raster < until)
+      until = raster;
+  }
+  return until;
+}
+
+void C64Timers::sync(uint8_t *vic, uint8_t *cia1, uint8_t *cia2)
+{
+  for (int i = 0; i < 2; i++) {
+    uint8_t *regs = i ? cia2 : cia1;
+    Cia &c = cia[i];
+    regs[0x4] = c.timer[0].counter & 0xff;
+    regs[0x5] = c.timer[0].counter >> 8;
+    regs[0x6] = c.timer[1].counter & 0xff;
+    regs[0x7] = c.timer[1].counter >> 8;
+    regs[0xd] = c.flags | ((c.flags & c.mask) ? 0x80 : 0);
+    c.flags = 0;
+  }
+
+  uint32_t line = raster_cycle / line_cycles;
+  vic[0x12] = line & 0xff;
+  vic[0x11] = (vic[0x11] & 0x7f) | ((line >> 1) & 0x80);
+  vic[0x19] = raster_flags | ((raster_flags & raster_mask) ? 0x80 : 0);
+  raster_flags = 0;
+}
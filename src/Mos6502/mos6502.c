@@ -34,11 +34,12 @@ modification, are permitted provided that the following conditions are met:
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "mos6502.h"
 
 #define V1 1    // works pretty well, no support for undocumented opcodes though...
-// #define V2 1 // does not work well... Usage not recommended.
-// #define V3 1 // does not work well... Usage not recommended.
+// #define V2 1 // does not work well... Usage not recommended. Not ported to Cpu6502.
+// #define V3 1 // does not work well... Usage not recommended. Not ported to Cpu6502.
 
 #ifdef V1
 #define FN 0x80
@@ -49,14 +50,35 @@ modification, are permitted provided that the following conditions are met:
 #define FZ 0x02
 #define FC 0x01
 
+#ifdef MOS6502_PAGED_MEMORY
+static inline unsigned char peek(const unsigned char *const *pages, unsigned int address)
+{
+  return pages[address >> 8][address & 0xff];
+}
+
+// Reads go through the page table, stores to the RAM copy of the page, made on the first store
+#define MEM(address) peek(pages, address)
+#define WPAGE(page) (ram[page] ? ram[page] : writepage(cpu, page))
+#define WMEM(address) (WPAGE((address) >> 8)[(address) & 0xff])
+#define MEMORY(cpu) const unsigned char *const *pages = (cpu)->pages
+#else
 #define MEM(address) (mem[address])
-#define LO() (MEM(pc))
-#define HI() (MEM(pc+1))
-#define FETCH() (MEM(pc++))
+#define WMEM(address) MEM(address)
+#define MEMORY(cpu) unsigned char *mem = (cpu)->mem
+#endif
 #define SETpc(newpc) (pc = (newpc))
-#define PUSH(data) (MEM(0x100 + (sp--)) = (data))
 #define POP() (MEM(0x100 + (++sp)))
 
+#define FETCH()                                             \
+{                                                           \
+  PROFILE_START();                                          \
+  op = MEM(pc++);                                           \
+  cpucycles += cpucycles_table[op];                         \
+}
+#define LO() (MEM(pc))
+#define HI() (MEM(pc+1))
+#define PUSH(data) { WMEM(0x100 + sp) = (data); DIRTY(0x100); sp--; writes++; }
+
 #define IMMEDIATE() (LO())
 #define ABSOLUTE() (LO() | (HI() << 8))
 #define ABSOLUTEX() (((LO() | (HI() << 8)) + x) & 0xffff)
@@ -68,9 +90,55 @@ modification, are permitted provided that the following conditions are met:
 #define INDIRECTY() (((MEM(LO()) | (MEM((LO() + 1) & 0xff) << 8)) + y) & 0xffff)
 #define INDIRECTZP() (((MEM(LO()) | (MEM((LO() + 1) & 0xff) << 8)) + 0) & 0xffff)
 
-#define WRITE(address)                  \
-{                                       \
-  /* cpuwritemap[(address) >> 6] = 1; */  \
+#ifdef MOS6502_PROFILE
+// The cycles of an instruction, including page crossings and taken branches,
+// are those counted from its fetch to the end of its handler
+#define PROFILE_START()                               \
+{                                                     \
+  ipc = pc;                                           \
+  icycles = cpucycles;                                \
+}
+#define PROFILE_END()                                 \
+{                                                     \
+  if (ipc - profile_base < profile_size)              \
+  {                                                   \
+    profile[ipc - profile_base].cycles += cpucycles - icycles; \
+    profile[ipc - profile_base].hits++;               \
+  }                                                   \
+}
+#else
+#define PROFILE_START()
+#define PROFILE_END()
+#endif
+
+// The sid areas $D400-$D7FF and $DE00-$DFFF, the CIAs at $DC00-$DDFF and the
+// VIC raster and interrupt registers $D011-$D01A
+#define QUEUED(addr)                                  \
+  (((addr) & 0x0c00) == 0x0400 ||                     \
+   ((addr) & 0x0c00) == 0x0c00 ||                     \
+   (((addr) & 0x0c00) == 0x0000 && (unsigned)(((addr) & 0x3f) - 0x11) < 10))
+
+// Stores mark the page they hit in the dirty bitmap. With paged memory the RAM
+// copies of the pages tell the same.
+#ifdef MOS6502_PAGED_MEMORY
+#define DIRTY(ea)
+#else
+#define DIRTY(ea) (cpu->dirty[(ea) >> 11] |= 1 << (((ea) >> 8) & 7))
+#endif
+
+#define WRITE(ea)                                     \
+{                                                     \
+  unsigned waddr = (ea);                              \
+  DIRTY(waddr);                                       \
+  writes++;                                           \
+  if ((waddr & 0xf000) == 0xd000 && QUEUED(waddr) &&  \
+      cpu->sidwrite_count < SIDWRITE_QUEUE_SIZE)      \
+  {                                                   \
+    SidWrite *w = &cpu->sidwrites[cpu->sidwrite_count++]; \
+    w->cycle = cpucycles;                             \
+    w->address = waddr;                               \
+    w->value = MEM(waddr);                            \
+  }                                                   \
 }
 
 #define EVALPAGECROSSING(baseaddr, realaddr) ((((baseaddr) ^ (realaddr)) & 0xff00) ? 1 : 0)
@@ -81,7 +149,8 @@ modification, are permitted provided that the following conditions are met:
 #define BRANCH()                                          \
 {                                                         \
   ++cpucycles;                                            \
-  temp = FETCH();                                         \
+  temp = LO();                                            \
+  pc++;                                                   \
   if (temp < 0x80)                                        \
   {                                                       \
     cpucycles += EVALPAGECROSSING(pc, pc + temp);         \
@@ -91,9 +160,38 @@ modification, are permitted provided that the following conditions are met:
   {                                                       \
     cpucycles += EVALPAGECROSSING(pc, pc + temp - 0x100); \
     SETpc(pc + temp - 0x100);                             \
+    IDLECHECK();                                          \
   }                                                       \
 }
 
+// Idle loops. Memory only changes through the stores of the cpu while it runs,
+// so a loop that comes back to the target of a backward branch or jump with the
+// same registers and no store since the last time can never be left. Whole
+// turns of it are then skipped up to the cycle budget, and the call ends at the
+// same instruction and cycle as when stepping through them, with CPU_IDLE.
+#define IDLECHECK()                                                     \
+{                                                                       \
+  if (pc == loop_pc && writes == loop_writes && a == loop_a &&          \
+      x == loop_x && y == loop_y && flags == loop_flags && sp == loop_sp) \
+  {                                                                     \
+    unsigned int period = cpucycles - loop_cycles;                      \
+    if (cpucycles - start < cycle_budget)                               \
+      cpucycles += (cycle_budget - (cpucycles - start)) / period * period; \
+    idle = 1;                                                           \
+  }                                                                     \
+  else                                                                  \
+  {                                                                     \
+    loop_pc = pc;                                                       \
+    loop_writes = writes;                                               \
+    loop_a = a;                                                         \
+    loop_x = x;                                                         \
+    loop_y = y;                                                         \
+    loop_flags = flags;                                                 \
+    loop_sp = sp;                                                       \
+  }                                                                     \
+  loop_cycles = cpucycles;                                              \
+}
+
 #define SETFLAGS(data)                  \
 {                                       \
   if (!(data))                          \
@@ -290,19 +388,6 @@ modification, are permitted provided that the following conditions are met:
   else flags &= ~FZ;                    \
 }
 
-void initcpu(unsigned short newpc, unsigned char newa, unsigned char newx, unsigned char newy);
-int runcpu(void);
-// void setpc(unsigned short newpc);
-
-unsigned int pc;
-unsigned char a;
-unsigned char x;
-unsigned char y;
-unsigned char flags;
-unsigned char sp;
-unsigned char mem[0x10000];
-unsigned int cpucycles;
-
 static const int cpucycles_table[] = 
 {
   7,  6,  0,  8,  3,  3,  5,  5,  3,  2,  2,  2,  4,  4,  6,  6, 
@@ -323,897 +408,1156 @@ static const int cpucycles_table[] =
   2,  5,  0,  8,  4,  4,  6,  6,  2,  4,  2,  7,  4,  4,  7,  7
 };
 
-void initcpu(unsigned short newpc, unsigned char newa, unsigned char newx, unsigned char newy)
+void initcpu(Cpu6502 *cpu, unsigned short newpc, unsigned char newa, unsigned char newx, unsigned char newy)
 {
-  pc = newpc;
-  a = newa;
-  x = newx;
-  y = newy;
-  flags = 0;
-  sp = 0xff;
-  cpucycles = 0;
+  cpu->pc = newpc;
+  cpu->a = newa;
+  cpu->x = newx;
+  cpu->y = newy;
+  cpu->flags = 0;
+  cpu->sp = 0xff;
+  cpu->cpucycles = 0;
 }
 
-int runcpu(void)
+#ifdef MOS6502_PROFILE
+void setprofile(Cpu6502 *cpu, PcProfile *profile, unsigned int base, unsigned int size)
 {
-  unsigned temp;
+  cpu->profile = profile;
+  cpu->profile_base = base;
+  cpu->profile_size = size;
+}
+#endif
+
+#ifdef MOS6502_PAGED_MEMORY
+// Read by the pages nothing is mapped at
+static const unsigned char blank[0x100];
+
+void initpages(Cpu6502 *cpu, unsigned char *pool, unsigned int pool_size)
+{
+  int i;
+
+  for (i = 0; i < 0x100; i++)
+  {
+    cpu->pages[i] = blank;
+    cpu->ram[i] = NULL;
+  }
+  cpu->pool = pool;
+  cpu->pool_size = pool_size;
+  cpu->pool_used = 0;
+  cpu->pool_full = 0;
+}
+
+void mapimage(Cpu6502 *cpu, const unsigned char *data, unsigned int address, unsigned int size)
+{
+  unsigned int end = address + size;
+  unsigned int page;
+
+  for (page = address >> 8; page < 0x100 && (page << 8) < end; page++)
+  {
+    unsigned int from = page << 8, to = from + 0x100;
+    if (from >= address && to <= end)
+    {
+      cpu->pages[page] = data + (from - address);
+      cpu->ram[page] = NULL;
+      continue;
+    }
+    if (from < address)
+      from = address;
+    if (to > end)
+      to = end;
+    memcpy(writepage(cpu, page) + (from & 0xff), data + (from - address), to - from);
+  }
+}
+
+unsigned char *writepage(Cpu6502 *cpu, unsigned int page)
+{
+  unsigned char *copy;
 
-  unsigned char op = FETCH();
+  if (cpu->ram[page])
+    return cpu->ram[page];
+  if (cpu->pool_used >= cpu->pool_size)
+  {
+    cpu->pool_full = 1;
+    return cpu->overflow;
+  }
+
+  copy = cpu->pool + (cpu->pool_used++ << 8);
+  memcpy(copy, cpu->pages[page], 0x100);
+  cpu->pages[page] = copy;
+  cpu->ram[page] = copy;
+  return copy;
+}
+#endif
+
+// Opcode dispatch. With GCC every handler ends by fetching the next opcode and jumping straight
+// to its handler through a table of label addresses (direct threading), which saves the bounds
+// check and the shared indirect jump of the switch. Other compilers dispatch through the switch.
+// Define MOS6502_SWITCH_DISPATCH to use the switch with GCC as well.
+#if defined(__GNUC__) && !defined(MOS6502_SWITCH_DISPATCH)
+#define THREADED_DISPATCH 1
+#endif
+
+#ifdef THREADED_DISPATCH
+#define OP(opcode) op_##opcode:
+#define OP_DEFAULT op_default:
+#define DISPATCH(op) goto *dispatch_table[op];
+#define NEXT()                          \
+{                                       \
+  STOPCHECK();                          \
+  FETCH();                              \
+  goto *dispatch_table[op];             \
+}
+#define REDISPATCH() goto *dispatch_table[op]
+#else
+#define OP(opcode) case opcode:
+#define OP_DEFAULT default:
+#define DISPATCH(op) switch(op)
+#define NEXT() break
+#define REDISPATCH() goto dispatch
+#endif
+
+// Fused handlers: the handler of the first opcode of a frequent pair runs the
+// second instruction in its own body, and the pair ends with a single dispatch.
+// Each instruction still ends with its stop check. When another opcode follows,
+// it is dispatched as usual. Only pairs whose first opcode is nearly always
+// followed by the second are fused, a miss costs a compare on top of the jump.
+#define FUSE(second)                    \
+{                                       \
+  STOPCHECK();                          \
+  FETCH();                              \
+  if (op != second)                     \
+    REDISPATCH();                       \
+}
+
+// bne or bpl after a decrement
+#define FUSE_BRANCH()                   \
+{                                       \
+  STOPCHECK();                          \
+  FETCH();                              \
+  if (op != 0xd0 && op != 0x10)         \
+    REDISPATCH();                       \
+  if (!(flags & (op == 0xd0 ? FZ : FN)))\
+    BRANCH()                            \
+  else                                  \
+    pc++;                               \
+}
+
+// Leave the dispatch loop after an instruction that was the last one of the call
+#define STOPCHECK()                     \
+{                                       \
+  PROFILE_END();                        \
+  for (i = 0; i < exit_count; i++)      \
+  {                                     \
+    if (pc == exit_pcs[i])              \
+    {                                   \
+      status = CPU_EXIT_PC;             \
+      goto done;                        \
+    }                                   \
+  }                                     \
+  if (cpucycles - start >= cycle_budget)\
+  {                                     \
+    status = idle ? CPU_IDLE : CPU_BUDGET; \
+    goto done;                          \
+  }                                     \
+}
+
+#define RETURN()                        \
+{                                       \
+  PROFILE_END();                        \
+  status = CPU_RETURNED;                \
+  goto done;                            \
+}
+
+// The registers are kept in locals while executing, stores to memory can then
+// not force them to be reloaded.
+int run_until_return(Cpu6502 *cpu, unsigned int cycle_budget, const unsigned short *exit_pcs,
+                     int exit_count, unsigned int *cycles_used)
+{
+#ifdef THREADED_DISPATCH
+  static const void *const dispatch_table[256] =
+  {
+    &&op_0x00, &&op_0x01, &&op_0x02, &&op_default, &&op_0x04, &&op_0x05, &&op_0x06, &&op_default,
+    &&op_0x08, &&op_0x09, &&op_0x0a, &&op_default, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_default,
+    &&op_0x10, &&op_0x11, &&op_default, &&op_default, &&op_0x14, &&op_0x15, &&op_0x16, &&op_default,
+    &&op_0x18, &&op_0x19, &&op_0x1a, &&op_default, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_default,
+    &&op_0x20, &&op_0x21, &&op_default, &&op_default, &&op_0x24, &&op_0x25, &&op_0x26, &&op_default,
+    &&op_0x28, &&op_0x29, &&op_0x2a, &&op_default, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_default,
+    &&op_0x30, &&op_0x31, &&op_default, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_default,
+    &&op_0x38, &&op_0x39, &&op_0x3a, &&op_default, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_default,
+    &&op_0x40, &&op_0x41, &&op_default, &&op_default, &&op_0x44, &&op_0x45, &&op_0x46, &&op_default,
+    &&op_0x48, &&op_0x49, &&op_0x4a, &&op_default, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_default,
+    &&op_0x50, &&op_0x51, &&op_default, &&op_default, &&op_0x54, &&op_0x55, &&op_0x56, &&op_default,
+    &&op_0x58, &&op_0x59, &&op_0x5a, &&op_default, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_default,
+    &&op_0x60, &&op_0x61, &&op_default, &&op_default, &&op_0x64, &&op_0x65, &&op_0x66, &&op_default,
+    &&op_0x68, &&op_0x69, &&op_0x6a, &&op_default, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_default,
+    &&op_0x70, &&op_0x71, &&op_default, &&op_default, &&op_0x74, &&op_0x75, &&op_0x76, &&op_default,
+    &&op_0x78, &&op_0x79, &&op_0x7a, &&op_default, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_default,
+    &&op_0x80, &&op_0x81, &&op_0x82, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_default,
+    &&op_0x88, &&op_0x89, &&op_0x8a, &&op_default, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_default,
+    &&op_0x90, &&op_0x91, &&op_default, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_default,
+    &&op_0x98, &&op_0x99, &&op_0x9a, &&op_default, &&op_default, &&op_0x9d, &&op_default, &&op_default,
+    &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+    &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_default, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+    &&op_0xb0, &&op_0xb1, &&op_default, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+    &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_default, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_default,
+    &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_default, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_default,
+    &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_default, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_default,
+    &&op_0xd0, &&op_0xd1, &&op_default, &&op_default, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_default,
+    &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_default, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_default,
+    &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_default, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_default,
+    &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_default,
+    &&op_0xf0, &&op_0xf1, &&op_default, &&op_default, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_default,
+    &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_default, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_default
+  };
+#endif
+  unsigned temp;
+  MEMORY(cpu);
+#ifdef MOS6502_PAGED_MEMORY
+  unsigned char *const *ram = cpu->ram;
+#endif
+  unsigned int pc = cpu->pc;
+  unsigned char a = cpu->a;
+  unsigned char x = cpu->x;
+  unsigned char y = cpu->y;
+  unsigned char flags = cpu->flags;
+  unsigned char sp = cpu->sp;
+  unsigned int cpucycles = cpu->cpucycles;
+  unsigned int start = cpucycles;
+#ifdef MOS6502_PROFILE
+  PcProfile *profile = cpu->profile;
+  unsigned int profile_base = cpu->profile_base;
+  unsigned int profile_size = profile ? cpu->profile_size : 0;
+  unsigned int ipc, icycles;
+#endif
+  unsigned int writes = 0;
+  unsigned int loop_pc = 0x10000, loop_cycles = 0, loop_writes = 0;
+  unsigned char loop_a = 0, loop_x = 0, loop_y = 0, loop_flags = 0, loop_sp = 0;
+  int idle = 0;
+  unsigned char op;
+  int status;
+  int i;
+
+next:
+  FETCH();
+#ifndef THREADED_DISPATCH
+dispatch:
+#endif
   /* printf("pc: %04x OP: %02x A:%02x X:%02x Y:%02x\n", pc-1, op, a, x, y); */
-  cpucycles += cpucycles_table[op];
-  switch(op)
+  DISPATCH(op)
   {
-    case 0xa7:
+    OP(0xa7)
     ASSIGNSETFLAGS(a, MEM(ZEROPAGE()));
     x = a;
     pc++;
-    break;
+    NEXT();
 
-    case 0xb7:
+    OP(0xb7)
     ASSIGNSETFLAGS(a, MEM(ZEROPAGEY()));
     x = a;
     pc++;
-    break;
+    NEXT();
 
-    case 0xaf:
+    OP(0xaf)
     ASSIGNSETFLAGS(a, MEM(ABSOLUTE()));
     x = a;
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xa3:
+    OP(0xa3)
     ASSIGNSETFLAGS(a, MEM(INDIRECTX()));
     x = a;
     pc++;
-    break;
+    NEXT();
 
-    case 0xb3:
+    OP(0xb3)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     ASSIGNSETFLAGS(a, MEM(INDIRECTY()));
     x = a;
     pc++;
-    break;
+    NEXT();
     
-    case 0x1a:
-    case 0x3a:
-    case 0x5a:
-    case 0x7a:
-    case 0xda:
-    case 0xfa:
-    break;
+    OP(0x1a)
+    OP(0x3a)
+    OP(0x5a)
+    OP(0x7a)
+    OP(0xda)
+    OP(0xfa)
+    NEXT();
     
-    case 0x80:
-    case 0x82:
-    case 0x89:
-    case 0xc2:
-    case 0xe2:
-    case 0x04:
-    case 0x44:
-    case 0x64:
-    case 0x14:
-    case 0x34:
-    case 0x54:
-    case 0x74:
-    case 0xd4:
-    case 0xf4:
-    pc++;
-    break;
+    OP(0x80)
+    OP(0x82)
+    OP(0x89)
+    OP(0xc2)
+    OP(0xe2)
+    OP(0x04)
+    OP(0x44)
+    OP(0x64)
+    OP(0x14)
+    OP(0x34)
+    OP(0x54)
+    OP(0x74)
+    OP(0xd4)
+    OP(0xf4)
+    pc++;
+    NEXT();
     
-    case 0x0c:
-    case 0x1c:
-    case 0x3c:
-    case 0x5c:
-    case 0x7c:
-    case 0xdc:
-    case 0xfc:
+    OP(0x0c)
+    OP(0x1c)
+    OP(0x3c)
+    OP(0x5c)
+    OP(0x7c)
+    OP(0xdc)
+    OP(0xfc)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x69:
+    OP(0x69)
     ADC(IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x65:
+    OP(0x65)
     ADC(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x75:
+    OP(0x75)
     ADC(MEM(ZEROPAGEX()));
     pc++;
-    break;
+    FUSE(0x95);
+    WMEM(ZEROPAGEX()) = a;
+    WRITE(ZEROPAGEX());
+    pc++;
+    NEXT();
 
-    case 0x6d:
+    OP(0x6d)
     ADC(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x7d:
+    OP(0x7d)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     ADC(MEM(ABSOLUTEX()));
      pc += 2;
-    break;
+    NEXT();
 
-    case 0x79:
+    OP(0x79)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     ADC(MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x61:
+    OP(0x61)
     ADC(MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x71:
+    OP(0x71)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     ADC(MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x29:
+    OP(0x29)
     AND(IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x25:
+    OP(0x25)
     AND(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x35:
+    OP(0x35)
     AND(MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x2d:
+    OP(0x2d)
     AND(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x3d:
+    OP(0x3d)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     AND(MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x39:
+    OP(0x39)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     AND(MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x21:
+    OP(0x21)
     AND(MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x31:
+    OP(0x31)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     AND(MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x0a:
+    OP(0x0a)
     ASL(a);
-    break;
+    NEXT();
 
-    case 0x06:
-    ASL(MEM(ZEROPAGE()));
+    OP(0x06)
+    ASL(WMEM(ZEROPAGE()));
+    WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x16:
-    ASL(MEM(ZEROPAGEX()));
+    OP(0x16)
+    ASL(WMEM(ZEROPAGEX()));
+    WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x0e:
-    ASL(MEM(ABSOLUTE()));
+    OP(0x0e)
+    ASL(WMEM(ABSOLUTE()));
+    WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x1e:
-    ASL(MEM(ABSOLUTEX()));
+    OP(0x1e)
+    ASL(WMEM(ABSOLUTEX()));
+    WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x90:
+    OP(0x90)
     if (!(flags & FC)) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0xb0:
+    OP(0xb0)
     if (flags & FC) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0xf0:
+    OP(0xf0)
     if (flags & FZ) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0x24:
+    OP(0x24)
     BIT(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x2c:
+    OP(0x2c)
     BIT(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x30:
+    OP(0x30)
     if (flags & FN) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0xd0:
+    OP(0xd0)
     if (!(flags & FZ)) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0x10:
+    OP(0x10)
     if (!(flags & FN)) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0x50:
+    OP(0x50)
     if (!(flags & FV)) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0x70:
+    OP(0x70)
     if (flags & FV) BRANCH()
     else pc++;
-    break;
+    NEXT();
 
-    case 0x18:
+    OP(0x18)
     flags &= ~FC;
-    break;
+    NEXT();
 
-    case 0xd8:
+    OP(0xd8)
     flags &= ~FD;
-    break;
+    NEXT();
 
-    case 0x58:
+    OP(0x58)
     flags &= ~FI;
-    break;
+    NEXT();
 
-    case 0xb8:
+    OP(0xb8)
     flags &= ~FV;
-    break;
+    NEXT();
 
-    case 0xc9:
+    OP(0xc9)
     CMP(a, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xc5:
+    OP(0xc5)
     CMP(a, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xd5:
+    OP(0xd5)
     CMP(a, MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xcd:
+    OP(0xcd)
     CMP(a, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xdd:
+    OP(0xdd)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     CMP(a, MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xd9:
+    OP(0xd9)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     CMP(a, MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xc1:
+    OP(0xc1)
     CMP(a, MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xd1:
+    OP(0xd1)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     CMP(a, MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xe0:
+    OP(0xe0)
     CMP(x, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xe4:
+    OP(0xe4)
     CMP(x, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xec:
+    OP(0xec)
     CMP(x, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xc0:
+    OP(0xc0)
     CMP(y, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xc4:
+    OP(0xc4)
     CMP(y, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xcc:
+    OP(0xcc)
     CMP(y, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xc6:
-    DEC(MEM(ZEROPAGE()));
+    OP(0xc6)
+    DEC(WMEM(ZEROPAGE()));
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    FUSE_BRANCH();
+    NEXT();
 
-    case 0xd6:
-    DEC(MEM(ZEROPAGEX()));
+    OP(0xd6)
+    DEC(WMEM(ZEROPAGEX()));
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0xce:
-    DEC(MEM(ABSOLUTE()));
+    OP(0xce)
+    DEC(WMEM(ABSOLUTE()));
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xde:
-    DEC(MEM(ABSOLUTEX()));
+    OP(0xde)
+    DEC(WMEM(ABSOLUTEX()));
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xca:
+    OP(0xca)
     x--;
     SETFLAGS(x);
-    break;
+    FUSE_BRANCH();
+    NEXT();
 
-    case 0x88:
+    OP(0x88)
     y--;
     SETFLAGS(y);
-    break;
+    FUSE_BRANCH();
+    NEXT();
 
-    case 0x49:
+    OP(0x49)
     EOR(IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x45:
+    OP(0x45)
     EOR(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x55:
+    OP(0x55)
     EOR(MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x4d:
+    OP(0x4d)
     EOR(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x5d:
+    OP(0x5d)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     EOR(MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x59:
+    OP(0x59)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     EOR(MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x41:
+    OP(0x41)
     EOR(MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x51:
+    OP(0x51)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     EOR(MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xe6:
-    INC(MEM(ZEROPAGE()));
+    OP(0xe6)
+    INC(WMEM(ZEROPAGE()));
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xf6:
-    INC(MEM(ZEROPAGEX()));
+    OP(0xf6)
+    INC(WMEM(ZEROPAGEX()));
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0xee:
-    INC(MEM(ABSOLUTE()));
+    OP(0xee)
+    INC(WMEM(ABSOLUTE()));
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xfe:
-    INC(MEM(ABSOLUTEX()));
+    OP(0xfe)
+    INC(WMEM(ABSOLUTEX()));
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xe8:
+    OP(0xe8)
     x++;
     SETFLAGS(x);
-    break;
+    NEXT();
 
-    case 0xc8:
+    OP(0xc8)
     y++;
     SETFLAGS(y);
-    break;
+    NEXT();
 
-    case 0x20:
+    OP(0x20)
     PUSH((pc+1) >> 8);
     PUSH((pc+1) & 0xff);
     pc = ABSOLUTE();
-    break;
+    NEXT();
 
-    case 0x4c:
+    OP(0x4c)
+    temp = pc - 1;
     pc = ABSOLUTE();
-    break;
+    if (pc <= temp)
+      IDLECHECK();
+    NEXT();
 
-    case 0x6c:
+    OP(0x6c)
     {
       unsigned short adr = ABSOLUTE();
       pc = (MEM(adr) | (MEM(((adr + 1) & 0xff) | (adr & 0xff00)) << 8));
     }
-    break;
+    NEXT();
 
-    case 0xa9:
+    OP(0xa9)
     ASSIGNSETFLAGS(a, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xa5:
+    OP(0xa5)
     ASSIGNSETFLAGS(a, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xb5:
+    OP(0xb5)
     ASSIGNSETFLAGS(a, MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xad:
+    OP(0xad)
     ASSIGNSETFLAGS(a, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xbd:
+    OP(0xbd)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     ASSIGNSETFLAGS(a, MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    FUSE(0x9d);
+    WMEM(ABSOLUTEX()) = a;
+    WRITE(ABSOLUTEX());
+    pc += 2;
+    NEXT();
 
-    case 0xb9:
+    OP(0xb9)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     ASSIGNSETFLAGS(a, MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    FUSE(0x8d);
+    WMEM(ABSOLUTE()) = a;
+    WRITE(ABSOLUTE());
+    pc += 2;
+    NEXT();
 
-    case 0xa1:
+    OP(0xa1)
     ASSIGNSETFLAGS(a, MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xb1:
+    OP(0xb1)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     ASSIGNSETFLAGS(a, MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xa2:
+    OP(0xa2)
     ASSIGNSETFLAGS(x, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xa6:
+    OP(0xa6)
     ASSIGNSETFLAGS(x, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xb6:
+    OP(0xb6)
     ASSIGNSETFLAGS(x, MEM(ZEROPAGEY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xae:
+    OP(0xae)
     ASSIGNSETFLAGS(x, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xbe:
+    OP(0xbe)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     ASSIGNSETFLAGS(x, MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xa0:
+    OP(0xa0)
     ASSIGNSETFLAGS(y, IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xa4:
+    OP(0xa4)
     ASSIGNSETFLAGS(y, MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xb4:
+    OP(0xb4)
     ASSIGNSETFLAGS(y, MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xac:
+    OP(0xac)
     ASSIGNSETFLAGS(y, MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xbc:
+    OP(0xbc)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     ASSIGNSETFLAGS(y, MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x4a:
+    OP(0x4a)
     LSR(a);
-    break;
+    NEXT();
 
-    case 0x46:
-    LSR(MEM(ZEROPAGE()));
+    OP(0x46)
+    LSR(WMEM(ZEROPAGE()));
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x56:
-    LSR(MEM(ZEROPAGEX()));
+    OP(0x56)
+    LSR(WMEM(ZEROPAGEX()));
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x4e:
-    LSR(MEM(ABSOLUTE()));
+    OP(0x4e)
+    LSR(WMEM(ABSOLUTE()));
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x5e:
-    LSR(MEM(ABSOLUTEX()));
+    OP(0x5e)
+    LSR(WMEM(ABSOLUTEX()));
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xea:
-    break;
+    OP(0xea)
+    NEXT();
 
-    case 0x09:
+    OP(0x09)
     ORA(IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x05:
+    OP(0x05)
     ORA(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x15:
+    OP(0x15)
     ORA(MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x0d:
+    OP(0x0d)
     ORA(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x1d:
+    OP(0x1d)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     ORA(MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x19:
+    OP(0x19)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     ORA(MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x01:
+    OP(0x01)
     ORA(MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x11:
+    OP(0x11)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     ORA(MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x48:
+    OP(0x48)
     PUSH(a);
-    break;
+    NEXT();
 
-    case 0x08:
+    OP(0x08)
     PUSH(flags | 0x30);
-    break;
+    NEXT();
 
-    case 0x68:
+    OP(0x68)
     ASSIGNSETFLAGS(a, POP());
-    break;
+    NEXT();
 
-    case 0x28:
+    OP(0x28)
     flags = POP();
-    break;
+    NEXT();
 
-    case 0x2a:
+    OP(0x2a)
     ROL(a);
-    break;
+    NEXT();
 
-    case 0x26:
-    ROL(MEM(ZEROPAGE()));
+    OP(0x26)
+    ROL(WMEM(ZEROPAGE()));
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x36:
-    ROL(MEM(ZEROPAGEX()));
+    OP(0x36)
+    ROL(WMEM(ZEROPAGEX()));
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x2e:
-    ROL(MEM(ABSOLUTE()));
+    OP(0x2e)
+    ROL(WMEM(ABSOLUTE()));
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x3e:
-    ROL(MEM(ABSOLUTEX()));
+    OP(0x3e)
+    ROL(WMEM(ABSOLUTEX()));
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x6a:
+    OP(0x6a)
     ROR(a);
-    break;
+    NEXT();
 
-    case 0x66:
-    ROR(MEM(ZEROPAGE()));
+    OP(0x66)
+    ROR(WMEM(ZEROPAGE()));
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x76:
-    ROR(MEM(ZEROPAGEX()));
+    OP(0x76)
+    ROR(WMEM(ZEROPAGEX()));
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x6e:
-    ROR(MEM(ABSOLUTE()));
+    OP(0x6e)
+    ROR(WMEM(ABSOLUTE()));
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x7e:
-    ROR(MEM(ABSOLUTEX()));
+    OP(0x7e)
+    ROR(WMEM(ABSOLUTEX()));
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x40:
-    if (sp == 0xff) return 0;
+    OP(0x40)
+    if (sp == 0xff) RETURN();
     flags = POP();
     pc = POP();
     pc |= POP() << 8;
-    break;
+    NEXT();
 
-    case 0x60:
-    if (sp == 0xff) return 0;
+    OP(0x60)
+    if (sp == 0xff) RETURN();
     pc = POP();
     pc |= POP() << 8;
     pc++;
-    break;
+    NEXT();
 
-    case 0xe9:
-    case 0xeb:
+    OP(0xe9)
+    OP(0xeb)
     SBC(IMMEDIATE());
     pc++;
-    break;
+    NEXT();
 
-    case 0xe5:
+    OP(0xe5)
     SBC(MEM(ZEROPAGE()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xf5:
+    OP(0xf5)
     SBC(MEM(ZEROPAGEX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xed:
+    OP(0xed)
     SBC(MEM(ABSOLUTE()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xfd:
+    OP(0xfd)
     cpucycles += EVALPAGECROSSING_ABSOLUTEX();
     SBC(MEM(ABSOLUTEX()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xf9:
+    OP(0xf9)
     cpucycles += EVALPAGECROSSING_ABSOLUTEY();
     SBC(MEM(ABSOLUTEY()));
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xe1:
+    OP(0xe1)
     SBC(MEM(INDIRECTX()));
     pc++;
-    break;
+    NEXT();
 
-    case 0xf1:
+    OP(0xf1)
     cpucycles += EVALPAGECROSSING_INDIRECTY();
     SBC(MEM(INDIRECTY()));
     pc++;
-    break;
+    NEXT();
 
-    case 0x38:
+    OP(0x38)
     flags |= FC;
-    break;
+    NEXT();
 
-    case 0xf8:
+    OP(0xf8)
     flags |= FD;
-    break;
+    NEXT();
 
-    case 0x78:
+    OP(0x78)
     flags |= FI;
-    break;
+    NEXT();
 
-    case 0x85:
-    MEM(ZEROPAGE()) = a;
+    OP(0x85)
+    WMEM(ZEROPAGE()) = a;
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x95:
-    MEM(ZEROPAGEX()) = a;
+    OP(0x95)
+    WMEM(ZEROPAGEX()) = a;
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x8d:
-    MEM(ABSOLUTE()) = a;
+    OP(0x8d)
+    WMEM(ABSOLUTE()) = a;
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x9d:
-    MEM(ABSOLUTEX()) = a;
+    OP(0x9d)
+    WMEM(ABSOLUTEX()) = a;
     WRITE(ABSOLUTEX());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x99:
-    MEM(ABSOLUTEY()) = a;
+    OP(0x99)
+    WMEM(ABSOLUTEY()) = a;
     WRITE(ABSOLUTEY());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x81:
-    MEM(INDIRECTX()) = a;
+    OP(0x81)
+    WMEM(INDIRECTX()) = a;
     WRITE(INDIRECTX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x91:
-    MEM(INDIRECTY()) = a;
+    OP(0x91)
+    WMEM(INDIRECTY()) = a;
     WRITE(INDIRECTY());
     pc++;
-    break;
+    NEXT();
 
-    case 0x86:
-    MEM(ZEROPAGE()) = x;
+    OP(0x86)
+    WMEM(ZEROPAGE()) = x;
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x96:
-    MEM(ZEROPAGEY()) = x;
+    OP(0x96)
+    WMEM(ZEROPAGEY()) = x;
     WRITE(ZEROPAGEY());
     pc++;
-    break;
+    NEXT();
 
-    case 0x8e:
-    MEM(ABSOLUTE()) = x;
+    OP(0x8e)
+    WMEM(ABSOLUTE()) = x;
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0x84:
-    MEM(ZEROPAGE()) = y;
+    OP(0x84)
+    WMEM(ZEROPAGE()) = y;
     WRITE(ZEROPAGE());
     pc++;
-    break;
+    NEXT();
 
-    case 0x94:
-    MEM(ZEROPAGEX()) = y;
+    OP(0x94)
+    WMEM(ZEROPAGEX()) = y;
     WRITE(ZEROPAGEX());
     pc++;
-    break;
+    NEXT();
 
-    case 0x8c:
-    MEM(ABSOLUTE()) = y;
+    OP(0x8c)
+    WMEM(ABSOLUTE()) = y;
     WRITE(ABSOLUTE());
     pc += 2;
-    break;
+    NEXT();
 
-    case 0xaa:
+    OP(0xaa)
     ASSIGNSETFLAGS(x, a);
-    break;
+    NEXT();
 
-    case 0xba:
+    OP(0xba)
     ASSIGNSETFLAGS(x, sp);
-    break;
+    NEXT();
 
-    case 0x8a:
+    OP(0x8a)
     ASSIGNSETFLAGS(a, x);
-    break;
+    NEXT();
 
-    case 0x9a:
+    OP(0x9a)
     sp = x;
-    break;
+    NEXT();
 
-    case 0x98:
+    OP(0x98)
     ASSIGNSETFLAGS(a, y);
-    break;
+    NEXT();
 
-    case 0xa8:
+    OP(0xa8)
     ASSIGNSETFLAGS(y, a);
-    break;
+    NEXT();
 
-    case 0x00:
-    return 0;
+    OP(0x00)
+    RETURN();
 
-    case 0x02:
+    OP(0x02)
     printf("Error: CPU halt at %04X\n", pc-1);
     // exit(1);
-    break;
+    NEXT();
           
-    default:
+    OP_DEFAULT
     printf("Error: Unknown opcode $%02X at $%04X\n", op, pc-1);
     // exit(1);
-    break;
+    NEXT();
   }
-  return 1;
+
+  STOPCHECK();
+  goto next;
+
+done:
+  if (cycles_used)
+    *cycles_used = cpucycles - start;
+  cpu->pc = pc;
+  cpu->a = a;
+  cpu->x = x;
+  cpu->y = y;
+  cpu->flags = flags;
+  cpu->sp = sp;
+  cpu->cpucycles = cpucycles;
+  return status;
+}
+
+// Execute one instruction, returns 0 on BRK or on RTS/RTI with an empty stack.
+int runcpu(Cpu6502 *cpu)
+{
+  return run_until_return(cpu, 0, 0, 0, 0) != CPU_RETURNED;
 }
 
 // void setpc(unsigned short newpc)
@@ -40,12 +40,108 @@ modification, are permitted provided that the following conditions are met:
 #ifdef __cplusplus
 extern "C" {
 #endif
-extern unsigned char mem[];
-// extern unsigned int cpucycles;
-extern unsigned int pc;
-// extern uint16_t pc;
-void initcpu(unsigned short newpc, unsigned char newa, unsigned char newx, unsigned char newy);
-int runcpu(void);
+// Writes to the sid areas $D400-$D7FF and $DE00-$DFFF are queued with the cpu
+// cycle they happen at, counted from initcpu(), and so are writes to the CIAs
+// at $DC00-$DDFF and to the VIC raster and interrupt registers $D011-$D01A. The
+// queue is emptied by the caller; once it is full, further writes only go to
+// memory.
+#ifndef SIDWRITE_QUEUE_SIZE
+#define SIDWRITE_QUEUE_SIZE 1024
+#endif
+
+typedef struct {
+  unsigned int cycle;
+  unsigned short address;
+  unsigned char value;
+} SidWrite;
+
+// Cycle profiler, off by default. When built in, the cycles and executions of
+// the instructions in an address range are added up in a table set with
+// setprofile(), one entry per address. A buffer covering the playroutine is
+// enough on small targets.
+// #define MOS6502_PROFILE 1
+
+#ifdef MOS6502_PROFILE
+typedef struct {
+  unsigned int cycles;            // cycles spent in the instruction at this address
+  unsigned int hits;              // times it was executed
+} PcProfile;
+#endif
+
+// Paged memory, off by default. The 64K are mapped in 256 byte pages instead of
+// held in one array: a page that is only read is read in place, from the tune
+// data in flash for example, and gets a RAM copy from a pool of pages set with
+// initpages() when it is first stored to. Reads cost one more lookup, in the page
+// table.
+// #define MOS6502_PAGED_MEMORY 1
+
+// State of one emulated cpu. The 64K of memory are owned by the caller, so
+// any number of cpus can run side by side.
+typedef struct {
+  unsigned int pc;
+  unsigned char a;
+  unsigned char x;
+  unsigned char y;
+  unsigned char flags;
+  unsigned char sp;
+  unsigned int cpucycles;
+#ifdef MOS6502_PAGED_MEMORY
+  const unsigned char *pages[0x100];    // where each page is read from
+  unsigned char *ram[0x100];            // its RAM copy, NULL until the page is stored to
+  unsigned char *pool;                  // RAM for pool_size pages, handed out in order
+  unsigned int pool_size;
+  unsigned int pool_used;
+  int pool_full;                        // a page found the pool used up, its stores were lost
+  unsigned char overflow[0x100];        // takes those stores
+#else
+  unsigned char *mem;
+#endif
+
+  SidWrite sidwrites[SIDWRITE_QUEUE_SIZE];
+  int sidwrite_count;
+
+  unsigned char dirty[0x10000 >> 11];   // 256 byte pages stored to, one bit each, cleared by the caller,
+                                        // not kept with paged memory
+
+#ifdef MOS6502_PROFILE
+  PcProfile *profile;                   // entries for the addresses from profile_base, or NULL
+  unsigned int profile_base;
+  unsigned int profile_size;
+#endif
+} Cpu6502;
+
+void initcpu(Cpu6502 *cpu, unsigned short newpc, unsigned char newa, unsigned char newx, unsigned char newy);
+int runcpu(Cpu6502 *cpu);
+#ifdef MOS6502_PAGED_MEMORY
+// Map every page to a page of zeros, and hand out RAM copies from the pool_size pages at pool
+void initpages(Cpu6502 *cpu, unsigned char *pool, unsigned int pool_size);
+// Map size bytes of data to address. The pages it covers whole are read in place, data must stay
+// valid; the pages at the ends are copied to RAM.
+void mapimage(Cpu6502 *cpu, const unsigned char *data, unsigned int address, unsigned int size);
+// The RAM copy of a page, made from what it reads on the first call
+unsigned char *writepage(Cpu6502 *cpu, unsigned int page);
+#endif
+#ifdef MOS6502_PROFILE
+// Profile the instructions at base to base + size - 1 into profile, NULL stops profiling.
+// The entries are added to, clear them to start over.
+void setprofile(Cpu6502 *cpu, PcProfile *profile, unsigned int base, unsigned int size);
+#endif
+
+// Results of run_until_return()
+enum {
+  CPU_RETURNED,     // RTS/RTI with an empty stack, or BRK
+  CPU_EXIT_PC,      // pc reached one of the exit addresses
+  CPU_BUDGET,       // the cycle budget is used up
+  CPU_IDLE          // the cycle budget is used up in a loop that never ends
+};
+
+// Run the routine set up by initcpu() in one call, until it returns, the pc reaches one of
+// the exit_count addresses in exit_pcs or cycle_budget cycles have been used. The cycles
+// used by the call are stored to cycles_used unless it is NULL. With a budget of 0 a single
+// instruction is executed. Loops that cannot end, such as JMP * or a poll of memory no store
+// changes, are skipped over to the end of the budget in one go.
+int run_until_return(Cpu6502 *cpu, unsigned int cycle_budget, const unsigned short *exit_pcs,
+                     int exit_count, unsigned int *cycles_used);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "SidTools.h"
+
+// Renders up to three sid chips clocked in lockstep and mixes them to mono or interleaved stereo.
+// The chips are rendered in short chunks into small scratch buffers, so the mixer reads them while
+// they are still in cache. All chips must share the same sampling parameters, they then produce the
+// same number of samples for the same number of cycles.
+// In stereo, the voices panned with SID::set_voice_pan() are spread over both channels and each chip
+// is placed with setPan(). A mono mix is not affected by panning and renders the chips without it.
+class SidMixer
+{
+public:
+	static const int MAX_SIDS = 3;
+
+	SidMixer() { pan_set = 0; clear(); }
+
+	// Attach a chip, returns its index or -1 if all slots are taken
+	int add(SID *sid);
+	void clear() { sid_count = 0; }
+
+	int count() { return sid_count; }
+	SID* get(int index) { return sids[index]; }
+
+	// Place chip index from -32768 (left) through 0 (both channels at unity) to 32767 (right),
+	// instead of the default placement. The placement is kept across clear().
+	void setPan(int index, int pan);
+	void resetPan() { pan_set = 0; setGains(); }
+
+	// Clock all chips for the given number of cycles, rendering at most n sample frames.
+	// Returns the number of sample frames rendered.
+	size_t readStereo(cycle_count cycles, int16_t *buffer, int n);
+	size_t readMono(cycle_count cycles, int16_t *buffer, int n);
+
+private:
+	static const int CHUNK = 64;				// samples per chip and pass
+
+	SID *sids[MAX_SIDS];
+	int32_t gain_left[MAX_SIDS];			// Q15 mixing gains
+	int32_t gain_right[MAX_SIDS];
+	int32_t gain_mono;
+	int32_t sid_pan[MAX_SIDS];
+	int pan_set;							// chips placed with setPan(), one bit each
+	int sid_count;
+
+	int16_t scratch[MAX_SIDS][CHUNK];
+	int16_t side[MAX_SIDS][CHUNK];			// panned voices, left = scratch + side, right = scratch - side
+
+	int render(cycle_count *cycles, int n, bool stereo, bool *sided);
+	void setGains();
+
+	static int16_t clamp(int32_t v) { return v >= 32767 ? 32767 : v < -32768 ? -32768 : v; }
+};
+
+int SidMixer::add(SID *sid)
+{
+  if (sid_count >= MAX_SIDS)
+    return -1;
+
+  sids[sid_count++] = sid;
+  setGains();
+  return sid_count - 1;
+}
+
+void SidMixer::setPan(int index, int pan)
+{
+  if (index < 0 || index >= MAX_SIDS)
+    return;
+
+  sid_pan[index] = pan < -32768 ? -32768 : pan > 32767 ? 32767 : pan;
+  pan_set |= 1 << index;
+  setGains();
+}
+
+// Default stereo placement: a single chip is centered, two chips are hard left and right, and
+// a third chip is centered between them. The gains of each side add up to unity.
+// Chips placed with setPan() get full gain on the near side and are attenuated on the other,
+// the stereo mix is clamped since the gains can then add up to more than unity.
+void SidMixer::setGains()
+{
+  if (!sid_count)
+    return;
+
+  const int32_t unity = 1 << 15;
+
+  if (sid_count == 1) {
+    gain_left[0] = gain_right[0] = unity;
+  } else if (sid_count == 2) {
+    gain_left[0] = unity; gain_right[0] = 0;
+    gain_left[1] = 0;     gain_right[1] = unity;
+  } else {
+    gain_left[0] = unity * 2 / 3; gain_right[0] = 0;
+    gain_left[1] = 0;             gain_right[1] = unity * 2 / 3;
+    gain_left[2] = gain_right[2] = unity - unity * 2 / 3;
+  }
+  for (int i = 0; i < sid_count; i++) {
+    if (pan_set & (1 << i)) {
+      gain_left[i] = sid_pan[i] <= 0 ? unity : unity - sid_pan[i];
+      gain_right[i] = sid_pan[i] >= 0 ? unity : unity + sid_pan[i];
+    }
+  }
+  gain_mono = unity / sid_count;
+}
+
+// Render one chunk of every chip into the scratch buffers, returns the number of samples.
+// For a stereo mix the chips with panned voices fill their side buffers too, *sided tells
+// whether any did.
+int SidMixer::render(cycle_count *cycles, int n, bool stereo, bool *sided)
+{
+  int samples = 0;
+
+  int panned = 0;
+
+  for (int i = 0; i < sid_count; i++) {
+    if (stereo && sids[i]->voice_panned()) {
+      samples = sids[i]->clock(cycles[i], scratch[i], side[i], n);
+      panned |= 1 << i;
+    } else {
+      samples = sids[i]->clock(cycles[i], scratch[i], n);
+    }
+  }
+
+  // The chips without panned voices have a silent side channel
+  *sided = panned != 0;
+  for (int i = 0; panned && i < sid_count; i++) {
+    if (!(panned & (1 << i)))
+      memset(side[i], 0, samples * sizeof(int16_t));
+  }
+
+  return samples;
+}
+
+size_t SidMixer::readStereo(cycle_count cycles, int16_t *buffer, int n)
+{
+  cycle_count left[MAX_SIDS] = { cycles, cycles, cycles };
+  size_t frames = 0;
+
+  if (!sid_count)
+    return 0;
+
+  while (left[0] > 0 && (int)frames < n) {
+    int chunk = n - (int)frames < CHUNK ? n - (int)frames : CHUNK;
+    bool sided;
+    int samples = render(left, chunk, true, &sided);
+
+    if (sided) {
+      for (int j = 0; j < samples; j++) {
+        int32_t l = 0, r = 0;
+        for (int i = 0; i < sid_count; i++) {
+          l += (scratch[i][j] + side[i][j]) * gain_left[i];
+          r += (scratch[i][j] - side[i][j]) * gain_right[i];
+        }
+        *buffer++ = clamp(l >> 15);
+        *buffer++ = clamp(r >> 15);
+      }
+    } else {
+      for (int j = 0; j < samples; j++) {
+        int32_t l = 0, r = 0;
+        for (int i = 0; i < sid_count; i++) {
+          l += scratch[i][j] * gain_left[i];
+          r += scratch[i][j] * gain_right[i];
+        }
+        *buffer++ = clamp(l >> 15);
+        *buffer++ = clamp(r >> 15);
+      }
+    }
+    frames += samples;
+  }
+  return frames;
+}
+
+size_t SidMixer::readMono(cycle_count cycles, int16_t *buffer, int n)
+{
+  cycle_count left[MAX_SIDS] = { cycles, cycles, cycles };
+  size_t frames = 0;
+
+  if (!sid_count)
+    return 0;
+
+  // A single chip at unity gain needs no mixing, it renders straight into the buffer
+  if (sid_count == 1)
+    return sids[0]->clock(left[0], buffer, n);
+
+  while (left[0] > 0 && (int)frames < n) {
+    int chunk = n - (int)frames < CHUNK ? n - (int)frames : CHUNK;
+    bool sided;
+    int samples = render(left, chunk, false, &sided);
+
+    for (int j = 0; j < samples; j++) {
+      int32_t v = 0;
+      for (int i = 0; i < sid_count; i++)
+        v += scratch[i][j];
+      *buffer++ = v * gain_mono >> 15;
+    }
+    frames += samples;
+  }
+  return frames;
+}
@@ -3,13 +3,39 @@
 #include "SidTools.h"
 #include "SDFat.h"
 
-#define MAX_INSTR 0x100000
+#define MAX_INIT_CYCLES 0x400000
+
+#ifdef MOS6502_PAGED_MEMORY
+#ifndef PAGE_POOL_SIZE
+#define PAGE_POOL_SIZE 48       // RAM pages for the pages a tune stores to, 12K
+#endif
+#endif
+
+// What tick() does once the playroutine has used up its cycle budget, the frame period,
+// in overrun_limit frames in a row
+enum OverrunPolicy {
+  OVERRUN_SKIP_FRAME,     // leave out the playroutine of the next frame
+  OVERRUN_HALF_SPEED,     // call the playroutine every other frame from then on
+  OVERRUN_STOP            // stop playing
+};
 
 struct SidPlayerConfig{
     uint16_t samplerate;
     int sid_model;
     int clockfreq;
 	float framerate;
+    sampling_method sampling;
+    OverrunPolicy overrun_policy;
+    int overrun_limit;
+    bool follow_model;      // play each tune on the chip model its header asks for
+};
+
+// Video standard a tune is made for, bits 2-3 of the flags word of a v2+ header
+enum SidClock {
+  SID_CLOCK_UNKNOWN,
+  SID_CLOCK_PAL,
+  SID_CLOCK_NTSC,
+  SID_CLOCK_ANY           // runs at either speed
 };
 
 struct SIDMetadata {
@@ -27,14 +53,42 @@ struct SIDMetadata {
   char author[32];
   char released[32];
   uint loadsize;
+  uint sidcount;          // number of sid chips, 2 or 3 for PSID v3/v4 multi sid tunes
+  uint sidaddress[3];     // base address of each chip, the first one is always $D400
+  byte sidmodel[3];       // 0 = unknown, 1 = 6581, 2 = 8580, 3 = both
+  uint flags;             // v2+, 0 for v1 headers
+  byte clock;             // SidClock, from flags
+  byte startpage;         // v2+, first page of the free memory a driver may use, 0 = none given
+  byte pagelength;        // number of free pages from startpage
 };
 
+#ifdef MOS6502_PROFILE
+// Cycles of the playroutine per frame, tracked while profiling
+struct FrameProfile {
+  uint32_t frames;
+  uint64_t cycles;        // of all frames
+  uint32_t last;          // of the last frame
+  uint32_t worst;         // of the most expensive frame
+  uint32_t worst_frame;   // number of that frame, counted from startProfile()
+};
+#endif
+
 class SidPlayer
 {
 public:
-	SidPlayer(SID *sid);
-
+	// The 64K of C64 memory are allocated unless a buffer is given, so several players can run side by side.
+	// With MOS6502_PAGED_MEMORY the buffer holds the PAGE_POOL_SIZE pages of the pool instead.
+	SidPlayer(SID *sid, uint8_t *memory = nullptr);
+	~SidPlayer();
+
+  // Load a tune, with a header read and a payload read from the source. A tune from a memory source
+  // is used in place, the memory must stay valid while it is loaded. Prints the header unless quiet.
+  int load(SidSource *source, bool quiet = false);
   int load(StreamFile<FatFile, uint32_t> *currFile);
+
+  // Bytes of a sid file header read by load(), and the parser of them
+  static const int HEADER_SIZE = 126;
+  static void parseHeader(const uint8_t *header, SIDMetadata *meta);
 	void play();
 	void playNext();
   void playTune(int subtune);
@@ -44,19 +98,62 @@ public:
 
 	inline bool isPlaying(void) { return playing; }	
 	size_t read(uint8_t *buffer);
+	size_t readMono(int16_t *buffer);
 
   void setSampleRate(uint32_t rate) { cfg.samplerate = rate; }
   uint32_t getSampleRate() { return(cfg.samplerate); }
 
-	// Provides the current number of samples per frame
+  // Selects the resampling method, takes effect on the next play()
+  void setSamplingMethod(sampling_method method) { cfg.sampling = method; }
+
+  // A tune that asks for the other chip model than the one given to the constructor is played on a chip
+  // of that model, created on demand and kept for the next tune. Turn it off to play every tune on the
+  // given chip. Takes effect on the next load().
+  void setFollowTuneModel(bool follow) { cfg.follow_model = follow; }
+
+  // A playroutine that runs past the end of its frame is cut off there. Sets what happens after
+  // limit such frames in a row, and counts the frames cut off since play().
+  void setOverrunPolicy(OverrunPolicy policy, int limit = 4) { cfg.overrun_policy = policy; cfg.overrun_limit = limit; }
+  uint32_t getOverruns() { return overruns; }
+
+	// Bytes of RAM taken by the memory of the tune: its loaded data and the 64K, or with paged memory
+	// its loaded data and the pages it stored to so far. Data used in place from a memory source
+	// is not counted.
+	uint32_t getMemoryUsed();
+
+	// With paged memory, whether the tune stored to more pages than the PAGE_POOL_SIZE pages of the
+	// pool hold. Its stores to the other pages are lost, play() and tick() then stop the tune. The
+	// tune needs a larger PAGE_POOL_SIZE. Always false with the 64K in RAM.
+	bool isMemoryFull();
+
+	// Provides the maximum number of samples rendered for the current frame
 	long getSamplesPerFrame() { return(samples_per_frame); }
 
-  // Expose the underlying SID object for per-voice output capture
-  SID* getSID() { return sid; }
+  // Expose the underlying SID objects for per-voice output capture
+  SID* getSID(int index = 0) { return mixer.get(index); }
+  int getSIDCount() { return mixer.count(); }
+
+  // Stereo placement for read(), -32768 is left, 0 centered and 32767 right.
+  // Voice panning applies to the voices mixed around the filter, see SID::set_voice_pan().
+  void setVoicePan(int index, int voice, int pan) { if (index < mixer.count()) mixer.get(index)->set_voice_pan(voice, pan); }
+  void setSidPan(int index, int pan) { mixer.setPan(index, pan); }
 
   // Expose delta_t (cycles per sample) for inline audio loops
   cycle_count getDeltaT() { return delta_t; }
 
+#ifdef MOS6502_PROFILE
+  // Playroutine profiler, built in with MOS6502_PROFILE in mos6502.h. Tracks the cycles of every
+  // frame, and with a buffer the cycles and executions of the instructions at base to base + size - 1.
+  // Start it after play() to leave out the init routine.
+  void startProfile(PcProfile *pcs = nullptr, uint16_t base = 0, uint32_t size = 0);
+  void stopProfile();
+  const FrameProfile &getFrameProfile() { return frame_profile; }
+
+  // Report the frame cycles and the top instructions by cycles, line by line to print or to a file
+  void reportProfile(void (*print)(const char *line, void *ref), void *ref = nullptr, int top = 16);
+  void reportProfile(FILE *file, int top = 16);
+#endif
+
   SIDMetadata	meta;
 
 private:
@@ -64,9 +161,11 @@ private:
 	const int SID_MODEL = 6581;
 	const float PAL_FRAMERATE = 50.0;
 	const int CLOCKFREQ = 985248;
+	const float NTSC_FRAMERATE = 59.826;
+	const int NTSC_CLOCKFREQ = 1022727;
 
-	long frame_period_us = 20000;	// raster line time in ms(PAL = 1000/50Hz = 20000 us)
-	int samples_per_frame = 441; 	// samplerate / framerate
+	long frame_period_us = 20000;	// frame time in cpu cycles, from one interrupt to the next (PAL VBI = 19656)
+	int samples_per_frame = 441; 	// upper bound of samples rendered per frame
 
 	SidPlayerConfig cfg;
 
@@ -74,103 +173,322 @@ private:
 
 	volatile bool playing;
 
+	uint32_t overruns;						// frames cut off at the cycle budget since play()
+	int overrun_run;						// of them in a row
+	bool skip_frame;						// degrade policy state
+	bool half_speed;
+	uint32_t frame_count;
+
 	SID *sid;
-  StreamFile<FatFile, uint32_t> *currfile;
+	Cpu6502 cpu;
+	uint8_t *mem;
+	bool own_mem;
+	const uint8_t *image;					// the tune as loaded, restored into mem before each play()
+	uint32_t image_size;
+	uint8_t *image_copy;					// owned copy when the source is not in memory
+	SID *model_sid;							// allocated on demand for tunes made for the other model
+	SID *extra_sids[SidMixer::MAX_SIDS - 1];	// allocated on demand for multi sid tunes
+	SidMixer mixer;
+	C64Timers timers;
+
+#ifdef MOS6502_PROFILE
+	bool profiling;
+	FrameProfile frame_profile;
+	PcProfile *pc_profile;
+	uint16_t pc_profile_base;
+	uint32_t pc_profile_size;
+#endif
+
+	void setupSids();
+	SID *chip(SID *&slot, chip_model model);
+	void restore();
+	void overrun();
+	bool checkMemory();
+	unsigned int runHandler(uint16_t address, unsigned int cycles, unsigned int budget, bool *overran);
+	void replayTimerWrites(unsigned int *now);
+
+	// The interrupt vector in RAM when the Kernal is banked out, otherwise the one the Kernal jumps through
+	uint16_t vector(uint16_t hardware, uint16_t kernal) {
+		uint16_t address = (peek(0x01) & 0x07) == 0x5 ? hardware : kernal;
+		return peek(address) | (peek(address + 1) << 8);
+	}
+
+	// Speed bit of a song, the songs above 32 use the bit of song 32
+	byte timerMode(uint song) { return meta.timermode[song > 32 ? 31 : song ? song - 1 : 0]; }
+
+	// The C64 memory as the player reads and writes it. at() points to the byte at address, valid up to
+	// the end of its page, poke() to where a store to address goes.
+#ifdef MOS6502_PAGED_MEMORY
+	const uint8_t *at(uint16_t address) { return cpu.pages[address >> 8] + (address & 0xff); }
+	uint8_t *poke(uint16_t address) { return writepage(&cpu, address >> 8) + (address & 0xff); }
+#else
+	const uint8_t *at(uint16_t address) { return &mem[address]; }
+	uint8_t *poke(uint16_t address) { return &mem[address]; }
+#endif
+	uint8_t peek(uint16_t address) { return *at(address); }
+	void applyWrite(const SidWrite &w);
+	void flushWrites();
+	size_t render(int16_t *buffer, bool stereo);
 
 	// Provides/sets the current frame period in us
 	long getFramePeriod() { return(frame_period_us); }
 	void setFramePeriod(long period_us) {
 		frame_period_us = period_us;
-    samples_per_frame = frame_period_us / delta_t;
+    // The fixed point resampler carries the fractional cycles between frames,
+    // so a frame yields either floor or ceil of the exact sample count.
+    samples_per_frame = (int64_t)frame_period_us * cfg.samplerate / cfg.clockfreq + 1;
 	}
 };
 
-SidPlayer::SidPlayer(SID *sid) { 
+SidPlayer::SidPlayer(SID *sid, uint8_t *memory) { 
     this->sid = sid;
+    own_mem = !memory;
+    image = nullptr;
+    image_size = 0;
+    image_copy = nullptr;
+#ifdef MOS6502_PAGED_MEMORY
+    mem = own_mem ? new uint8_t[PAGE_POOL_SIZE << 8] : memory;
+    initpages(&cpu, mem, PAGE_POOL_SIZE);
+#else
+    mem = own_mem ? new uint8_t[0x10000] : memory;
+    memset(mem, 0, 0x10000);
+    cpu.mem = mem;
+#endif
+    cpu.sidwrite_count = 0;
+    memset(cpu.dirty, 0, sizeof(cpu.dirty));
+#ifdef MOS6502_PROFILE
+    profiling = false;
+    pc_profile = nullptr;
+    setprofile(&cpu, nullptr, 0, 0);
+#endif
+    model_sid = nullptr;
+    for (int i = 0; i < SidMixer::MAX_SIDS - 1; i++)
+      extra_sids[i] = nullptr;
+    meta.sidcount = 1;
+    meta.sidaddress[0] = 0xd400;
+    mixer.add(sid);
     cfg.samplerate = SAMPLERATE;
     cfg.sid_model = SID_MODEL;
     cfg.clockfreq = CLOCKFREQ;
     cfg.framerate = PAL_FRAMERATE;
+    cfg.sampling = SAMPLE_FAST;
+    cfg.overrun_policy = OVERRUN_SKIP_FRAME;
+    cfg.overrun_limit = 4;
+    cfg.follow_model = true;
     // cfg.subtune = 1;      
 }
 
-int SidPlayer::load(StreamFile<FatFile, uint32_t> *currFile) {
-  const int SidHeaderSize = 126;
-  unsigned int header[SidHeaderSize];
-  uint32_t loadpos;
+SidPlayer::~SidPlayer() {
+  delete model_sid;
+  for (int i = 0; i < SidMixer::MAX_SIDS - 1; i++)
+    delete extra_sids[i];
+  if (own_mem)
+    delete[] mem;
+  delete[] image_copy;
+}
 
-  memset(&meta, 0, sizeof(meta));
-  memset(&mem, 0, 0x10000);
+// Attach the primary chip and one chip for each extra sid declared in the header. The primary chip
+// is the one given to the constructor unless the tune asks for the other model. The extra chips are
+// of their declared model, or of the model of the primary chip when the header leaves it open.
+void SidPlayer::setupSids() {
+  chip_model primary_model = sid->get_chip_model();
+  SID *primary = sid;
+
+  if (cfg.follow_model && (meta.sidmodel[0] == 1 || meta.sidmodel[0] == 2)) {
+    chip_model model = meta.sidmodel[0] == 2 ? MOS8580 : MOS6581;
+    if (model != primary_model) {
+      primary = chip(model_sid, model);
+      primary_model = model;
+    }
+  }
+
+  mixer.clear();
+  mixer.add(primary);
+
+  for (uint i = 1; i < meta.sidcount; i++) {
+    chip_model model = meta.sidmodel[i] == 1 ? MOS6581 : meta.sidmodel[i] == 2 ? MOS8580 : primary_model;
+    mixer.add(chip(extra_sids[i - 1], model));
+  }
+}
 
-  // fetch sid header
-  currFile->seekSet(0);
-  for(int idx = 0; idx < SidHeaderSize; idx++) {
-    header[idx] = currFile->read();
+// The chip kept in slot, replaced by a new one when it is missing or of the other model
+SID *SidPlayer::chip(SID *&slot, chip_model model) {
+  if (slot && slot->get_chip_model() != model) {
+    delete slot;
+    slot = nullptr;
   }
+  if (!slot) {
+    if (model == MOS8580)
+      slot = new SID8580();
+    else
+      slot = new SID6581();
+  }
+  return slot;
+}
+
+int SidPlayer::load(StreamFile<FatFile, uint32_t> *currFile) {
+  SdFatSidSource source(currFile);
+
+  if (!load(&source)) {
+    currFile->close();
+    return 0;
+  }
+  return 1;
+}
+
+// Fill meta from the header of a sid file, the fields given in the data are left to load()
+void SidPlayer::parseHeader(const uint8_t *header, SIDMetadata *meta) {
+  memset(meta, 0, sizeof(*meta));
 
   // Read interesting bits of the SID header
   // Big endian format!
-  meta.version = (header[4] << 8) | header[5];  
-  meta.dataoffset = (header[6] << 8) | header[7];
-  meta.loadaddress = (header[8] << 8) | header[9];
-  meta.initaddress = (header[10] << 8) | header[11];
-  meta.playaddress = (header[12] << 8) | header[13];
-  meta.songs = (header[14] << 8) | header[15];
-  meta.startsong = (header[16] << 8) | header[17];
+  meta->version = (header[4] << 8) | header[5];  
+  meta->dataoffset = (header[6] << 8) | header[7];
+  meta->loadaddress = (header[8] << 8) | header[9];
+  meta->initaddress = (header[10] << 8) | header[11];
+  meta->playaddress = (header[12] << 8) | header[13];
+  meta->songs = (header[14] << 8) | header[15];
+  meta->startsong = (header[16] << 8) | header[17];
 
   for (int i = 0; i < 32; i++) {
-    meta.timermode[31 - i] = (header[0x12 + (i >> 3)] & (byte)pow(2, 7 - i % 8)) ? 1 : 0;
+    meta->timermode[31 - i] = (header[0x12 + (i >> 3)] & (byte)pow(2, 7 - i % 8)) ? 1 : 0;
+  }
+
+  // The flags word of v2 on holds the video standard and the chip models, followed by the free
+  // memory a driver may use. The second and third sid addresses are given as the middle byte of
+  // the address in v3 and v4. Valid addresses are even values in $42-$7F and $E0-$FE.
+  meta->sidcount = 1;
+  meta->sidaddress[0] = 0xd400;
+  if (meta->version >= 2) {
+    meta->flags = (header[0x76] << 8) | header[0x77];
+    meta->clock = (meta->flags >> 2) & 0x03;
+    for (int i = 0; i < 3; i++)
+      meta->sidmodel[i] = (meta->flags >> (4 + 2 * i)) & 0x03;
+    meta->startpage = header[0x78];
+    meta->pagelength = header[0x79];
+  }
+  for (int i = 1; i < 3 && meta->version >= (uint)(2 + i); i++) {
+    uint addr = header[0x79 + i];
+    if ((addr & 1) || !((addr >= 0x42 && addr <= 0x7f) || (addr >= 0xe0 && addr <= 0xfe)))
+      break;
+    meta->sidaddress[meta->sidcount++] = 0xd000 | (addr << 4);
   }
 
   for (int cc = 0; cc < 4; cc++)
-    meta.magicID[cc] = header[cc];
+    meta->magicID[cc] = header[cc];
 
   for (int cc = 0; cc < 31; cc++)
   {
-    meta.name[cc] = header[0x16 + cc];
-    meta.author[cc] = header[0x36 + cc];
-    meta.released[cc] = header[0x56 + cc];
+    meta->name[cc] = header[0x16 + cc];
+    meta->author[cc] = header[0x36 + cc];
+    meta->released[cc] = header[0x56 + cc];
   }
+}
 
-  currFile->seekSet(meta.dataoffset);
-
+int SidPlayer::load(SidSource *source, bool quiet) {
+  uint8_t header[HEADER_SIZE];
+  uint32_t loadpos;
+  uint32_t file_size = source->size();
+
+#ifdef MOS6502_PAGED_MEMORY
+  initpages(&cpu, mem, PAGE_POOL_SIZE);
+#else
+  memset(mem, 0, 0x10000);
+#endif
+  memset(cpu.dirty, 0, sizeof(cpu.dirty));
+  delete[] image_copy;
+  image_copy = nullptr;
+  image = nullptr;
+  image_size = 0;
+
+  // fetch sid header, a short file leaves the rest zero
+  memset(header, 0, sizeof(header));
+  source->read(0, header, HEADER_SIZE);
+
+  parseHeader(header, &meta);
+  setupSids();
+
+  // NTSC tunes run at the NTSC clock and frame rate, all others at the PAL ones
+  bool ntsc = meta.clock == SID_CLOCK_NTSC;
+  cfg.clockfreq = ntsc ? NTSC_CLOCKFREQ : CLOCKFREQ;
+  cfg.framerate = ntsc ? NTSC_FRAMERATE : PAL_FRAMERATE;
+
+  loadpos = meta.dataoffset;
   if (meta.loadaddress == 0)
   {
     // Ok, loadaddress is given by the first 2 bytes in the actual sid data
     // Little endian format!
-    meta.loadaddress = currFile->read() | (currFile->read() << 8);
+    uint8_t address[2] = { 0, 0 };
+    source->read(loadpos, address, 2);
+    meta.loadaddress = address[0] | (address[1] << 8);
+    loadpos += 2;
   }
 
   // Load the C64 data
-  loadpos = currFile->curPosition();
-  meta.loadsize = currFile->size() - loadpos;
+  meta.loadsize = file_size > loadpos ? file_size - loadpos : 0;
 
-  // Print info & run initroutine
-  printf("Load address: $%04X Init address: $%04X Play address: $%04X\n", meta.loadaddress, meta.initaddress, meta.playaddress);
-  printf("Songs: %02d Start song: %02d \n", meta.songs, meta.startsong);
-  printf("Name: %s\n", meta.name);
-  printf("Author: %s\n", meta.author);
-  printf("Released: %s\n", meta.released);
+  if (!quiet) {
+    // Print info & run initroutine
+    printf("Load address: $%04X Init address: $%04X Play address: $%04X\n", meta.loadaddress, meta.initaddress, meta.playaddress);
+    printf("Songs: %02d Start song: %02d \n", meta.songs, meta.startsong);
+    printf("Name: %s\n", meta.name);
+    printf("Author: %s\n", meta.author);
+    printf("Released: %s\n", meta.released);
 
-  printf("Timermodes: ");
-  for (int i = 0; i < 32; i++) { printf(" %1d", meta.timermode[31 - i]); }
+    static const char *clocks[] = { "unknown", "PAL", "NTSC", "PAL and NTSC" };
+    static const char *models[] = { "unknown", "6581", "8580", "6581 and 8580" };
+    printf("Clock: %s Model: %s\n", clocks[meta.clock], models[meta.sidmodel[0]]);
 
-  printf("\n");
+    for (uint i = 1; i < meta.sidcount; i++)
+      printf("SID %d at $%04X Model: %s\n", i + 1, meta.sidaddress[i], models[meta.sidmodel[i]]);
+
+    printf("Timermodes: ");
+    for (int i = 0; i < 32; i++) { printf(" %1d", meta.timermode[31 - i]); }
+
+    printf("\n");
+  }
+
+  // Bit 0 marks Compute! Sidplayer data in a PSID, which needs that player around it. In an RSID
+  // bit 1 marks a BASIC program, which needs the BASIC ROM.
+  bool rsid = meta.magicID[0] == 'R';
+  if (!rsid && (meta.flags & 0x01))
+  {
+    printf("Error: SID data is Compute! Sidplayer music, not supported.\n");
+    return 0;
+  }
+  if (rsid && (meta.flags & 0x02))
+    printf("Warning: SID needs C64 BASIC, which is not emulated\n");
 
   if (meta.loadsize + meta.loadaddress >= 0x10000)
   {
     printf("Error: SID data continues past end of C64 memory.\n");
-    currFile->close();
     return 0;
   }
 
-  // load sid song into memory!
-  for (uint32_t i=0; i < meta.loadsize; i++) {
-    mem[meta.loadaddress+i] = currFile->read();
+  // The tune is kept as loaded to start every subtune from, in place when the source is in memory
+  if (source->data()) {
+    image = source->data() + loadpos;
+  } else {
+    image_copy = new uint8_t[meta.loadsize];
+    if (source->read(loadpos, image_copy, meta.loadsize) != meta.loadsize) {
+      printf("Error: could not read the SID data.\n");
+      delete[] image_copy;
+      image_copy = nullptr;
+      return 0;
+    }
+    image = image_copy;
   }
-
-  // set default song
+  image_size = meta.loadsize;
+#ifdef MOS6502_PAGED_MEMORY
+  mapimage(&cpu, image, meta.loadaddress, image_size);
+#else
+  memcpy(&mem[meta.loadaddress], image, image_size);
+#endif
+
+  // set default song, a start song of 0 or past the last song means the first one
   // cfg.subtune = meta.startsong;
+  if (meta.startsong < 1 || meta.startsong > meta.songs)
+    meta.startsong = 1;
   meta.currentsong = meta.startsong;
 
   return 1;  
@@ -178,57 +496,115 @@ int SidPlayer::load(StreamFile<FatFile, uint32_t> *currFile) {
 
 void SidPlayer::play()
 {
-  int instr = 0;
+  unsigned int init_cycles = 0;
+  unsigned int now = 0;
+  unsigned int idle_pc = 0x10000;
+  int idle_lines = 0;
 
+  restore();
 	reset();
 
-	sid->set_sampling_parameters(cfg.clockfreq, SAMPLE_FAST, cfg.samplerate);
+  overruns = 0;
+  overrun_run = 0;
+  skip_frame = false;
+  half_speed = false;
+  frame_count = 0;
+
+  for (int i = 0; i < mixer.count(); i++)
+    mixer.get(i)->set_sampling_parameters(cfg.clockfreq, cfg.sampling, cfg.samplerate);
 
 	delta_t = (int)((uint32_t)cfg.clockfreq / (uint32_t) cfg.samplerate);
 
-	setFramePeriod(cfg.clockfreq / cfg.framerate);
+  // The raster geometry follows the clock, 63 cycles by 312 lines for PAL and 65 by 263 for NTSC.
+  // The Kernal leaves timer A of CIA 1 running at about 60Hz with its interrupt enabled.
+  bool ntsc = cfg.clockfreq > 1000000;
+  int line_cycles = ntsc ? 65 : 63;
+  timers.reset(line_cycles, (int)(cfg.clockfreq / cfg.framerate) / line_cycles, ntsc ? 0x4295 : 0x4025);
+
+  // A PSID tune is called from the interrupt of its speed bit, like the PSID driver of sidplay
+  // sets it up: the raster interrupt at the top of the screen, or the Kernal timer. RSID tunes
+  // set up their own interrupts.
+  if (meta.magicID[0] != 'R') {
+    if (timerMode(meta.currentsong)) {
+      timers.write(0xdc0d, 0x81);
+    } else {
+      timers.write(0xdc0d, 0x7f);
+      timers.write(0xd012, 0x00);
+      timers.write(0xd01a, 0x01);
+    }
+  }
+  timers.sync(poke(0xd000), poke(0xdc00), poke(0xdd00));
+
+	setFramePeriod(timers.getFrameCycles());
   
-  mem[0x01] = 0x37;
+  *poke(0x01) = 0x37;
 
   printf("Playing subtune %d\n", meta.currentsong);
 
-  initcpu(meta.initaddress, meta.currentsong-1, 0, 0);
+  initcpu(&cpu, meta.initaddress, meta.currentsong-1, 0, 0);
 
-  while (runcpu())
+  // Run the init routine a raster line at a time, with the timers and the raster moving on
+  for (;;)
   {
-    // Allow SID model detection (including $d011 wait) to eventually terminate
-    ++mem[0xd012];
-    if (!mem[0xd012] || ((mem[0xd011] & 0x80) && mem[0xd012] >= 0x38))
+    unsigned int used;
+    int result = run_until_return(&cpu, timers.getLineCycles(), 0, 0, &used);
+
+    replayTimerWrites(&now);
+    timers.advance(cpu.cpucycles - now);
+    now = cpu.cpucycles;
+    timers.sync(poke(0xd000), poke(0xdc00), poke(0xdd00));
+    cpu.sidwrite_count = 0;
+
+    if (result == CPU_RETURNED)
+      break;
+
+    // A loop that stays idle for a whole frame while the raster moves on is
+    // the main loop of the tune, not a wait in the init
+    if (result == CPU_IDLE && cpu.pc == idle_pc)
+    {
+      if (++idle_lines >= timers.getLines())
+      {
+        printf("Init ended in a main loop at $%04x\n", cpu.pc);
+        break;
+      }
+    }
+    else
     {
-        mem[0xd011] ^= 0x80;
-        mem[0xd012] = 0x00;
+      idle_pc = result == CPU_IDLE ? cpu.pc : 0x10000;
+      idle_lines = 0;
     }
-    instr++;
-    if (instr > MAX_INSTR)
+
+    init_cycles += used;
+    if (init_cycles > MAX_INIT_CYCLES)
     {
-      printf("Warning: CPU executed a high number of instructions in init, breaking\n");
+      printf("Warning: CPU used a high number of cycles in init, breaking\n");
       break;
     }
   }
 
+  if (!checkMemory())
+    return;
+
+  // The init routine runs before playback starts, its register values take
+  // effect at once. Interrupts raised meanwhile are dropped, the first frame
+  // lasts until the next one.
+  cpu.sidwrite_count = 0;
+  timers.take();
+  for (int i = 0; i < mixer.count(); i++)
+    mixer.get(i)->write_block(at(meta.sidaddress[i]));
+
   if (meta.playaddress == 0)
   {
+    // The vector is read again at every interrupt, handlers may chain to each other
     printf("Warning: SID has play address 0, reading from interrupt vector instead\n");
-    if ((mem[0x01] & 0x07) == 0x5)
-      meta.playaddress = mem[0xfffe] | (mem[0xffff] << 8);
-    else
-      meta.playaddress = mem[0x314] | (mem[0x315] << 8);
-    printf("New play address is $%04X\n", meta.playaddress);
+    printf("New play address is $%04X\n", vector(0xfffe, 0x314));
   } else {
-    if (meta.playaddress >= 0xe000 && mem[1] == 0x37)
-      mem[1]=0x35;
+    if (meta.playaddress >= 0xe000 && peek(0x01) == 0x37)
+      *poke(0x01) = 0x35;
   }
 
-  if (meta.timermode[meta.currentsong-1] || mem[0xdc05]) { //CIA timing
-    if (!mem[0xdc05]) { mem[0xdc04] = 0x24; mem[0xdc05] = 0x40; } //C64 startup-default
-    setFramePeriod(mem[0xdc04] + mem[0xdc05] * 256);
-  }
-  else setFramePeriod(cfg.clockfreq / cfg.framerate);  //Vsync timing
+  uint32_t until = timers.next();
+  setFramePeriod(until < timers.getFrameCycles() ? until : timers.getFrameCycles());
 
 	printf("cpu_clk: %ld samplerate: %ld samples/frame: %ld frame period: %ld delta_t: %ld timing: %d\n", \
           cfg.clockfreq,        \
@@ -236,11 +612,64 @@ void SidPlayer::play()
           samples_per_frame, \
           frame_period_us,     \
           delta_t,              \
-          meta.timermode[meta.currentsong-1]);
+          timerMode(meta.currentsong));
 
 	playing = true;
 }
 
+// Put the pages stored to since the tune was loaded back as they were loaded, so that every
+// subtune starts from the same memory. The pages the player writes itself are always put back.
+void SidPlayer::restore()
+{
+#ifdef MOS6502_PAGED_MEMORY
+  // Dropping the RAM copies of the pages puts them all back
+  initpages(&cpu, mem, PAGE_POOL_SIZE);
+  mapimage(&cpu, image, meta.loadaddress, image_size);
+#else
+  static const uint8_t player_pages[] = { 0x00, 0xd0, 0xdc, 0xdd };
+  uint32_t start = meta.loadaddress;
+  uint32_t end = start + image_size;
+
+  for (uint8_t page : player_pages)
+    cpu.dirty[page >> 3] |= 1 << (page & 7);
+
+  for (uint32_t page = 0; page < 0x100; page++) {
+    if (!(cpu.dirty[page >> 3] & (1 << (page & 7))))
+      continue;
+
+    uint32_t from = page << 8, to = from + 0x100;
+    memset(&mem[from], 0, 0x100);
+    if (from < start)
+      from = start;
+    if (to > end)
+      to = end;
+    if (from < to)
+      memcpy(&mem[from], &image[from - start], to - from);
+  }
+  memset(cpu.dirty, 0, sizeof(cpu.dirty));
+#endif
+}
+
+uint32_t SidPlayer::getMemoryUsed()
+{
+  uint32_t copy = image_copy ? image_size : 0;
+
+#ifdef MOS6502_PAGED_MEMORY
+  return copy + (cpu.pool_used << 8);
+#else
+  return copy + 0x10000;
+#endif
+}
+
+bool SidPlayer::isMemoryFull()
+{
+#ifdef MOS6502_PAGED_MEMORY
+  return cpu.pool_full;
+#else
+  return false;
+#endif
+}
+
 void SidPlayer::playNext() {
   meta.currentsong = (meta.currentsong == meta.songs) ? 1 : (meta.currentsong+1);
   play();
@@ -256,12 +685,15 @@ void SidPlayer::playTune(int subtune) {
 
 void SidPlayer::reset(void)
 {
-	sid->reset();
+  cpu.sidwrite_count = 0;
 
-  // reset sid's memory mapped registers too
-  for (int reg = 0; reg < 25; reg++)
-    mem[0xd400 + reg] = 0;
+  for (int i = 0; i < mixer.count(); i++) {
+    mixer.get(i)->reset();
 
+    // reset sid's memory mapped registers too
+    for (int reg = 0; reg < 25; reg++)
+      *poke(meta.sidaddress[i] + reg) = 0;
+  }
 }
 
 void SidPlayer::stop(void)
@@ -271,50 +703,318 @@ void SidPlayer::stop(void)
 
 int SidPlayer::tick(void)
 {
-  // Run the playroutine
-  int instr = 0;
-  initcpu(meta.playaddress, 0, 0, 0);
-  while (runcpu())
+  if (!playing)
+    return 1;
+
+  // Writes of a frame that was not rendered take effect before this frame
+  flushWrites();
+
+  // The interrupts raised at the start of the frame call their handlers. Each handler may
+  // run until the next interrupt of its kind, at most a video frame.
+  int raised = timers.take();
+  unsigned int frame_cycles = timers.getFrameCycles();
+  unsigned int irq_budget = timers.next(C64Timers::IRQ);
+  unsigned int nmi_budget = timers.next(C64Timers::NMI);
+  if (irq_budget > frame_cycles)
+    irq_budget = frame_cycles;
+  if (nmi_budget > frame_cycles)
+    nmi_budget = frame_cycles;
+
+  // A degraded tune leaves out the playroutine at some interrupts
+  if (raised) {
+    frame_count++;
+    if (skip_frame || (half_speed && (frame_count & 1))) {
+      skip_frame = false;
+      raised = 0;
+    }
+  }
+
+  unsigned int cycles = 0;
+  bool overran = false;
+  if (raised & C64Timers::IRQ)
+    cycles = runHandler(meta.playaddress ? meta.playaddress : vector(0xfffe, 0x314), cycles, irq_budget, &overran);
+  if (raised & C64Timers::NMI)
+    cycles = runHandler(vector(0xfffa, 0x318), cycles, nmi_budget, &overran);
+  if (!checkMemory())
+    return 1;
+
+  // The writes up to the cut are rendered as usual
+  if (overran)
+    overrun();
+  else if (raised)
+    overrun_run = 0;
+
+#ifdef MOS6502_PROFILE
+  if (profiling && raised) {
+    if (cycles > frame_profile.worst) {
+      frame_profile.worst = cycles;
+      frame_profile.worst_frame = frame_profile.frames;
+    }
+    frame_profile.last = cycles;
+    frame_profile.cycles += cycles;
+    frame_profile.frames++;
+  }
+#endif
+
+  // Replay the timer writes of the handlers. The frame ends at the next interrupt after them,
+  // at most a video frame, or right after the handlers when one was raised while they ran or
+  // they ran past the video frame.
+  unsigned int now = 0;
+  replayTimerWrites(&now);
+  if (cycles > now) {
+    timers.advance(cycles - now);
+    now = cycles;
+  }
+  unsigned int frame = now;
+  if (now < frame_cycles && !timers.raised()) {
+    uint32_t until = timers.next();
+    if (until > frame_cycles - now)
+      until = frame_cycles - now;
+    frame = now + until;
+  }
+  timers.advance(frame - now);
+  timers.sync(poke(0xd000), poke(0xdc00), poke(0xdd00));
+  setFramePeriod(frame);
+
+  return playing ? 0 : 1;
+}
+
+// Run an interrupt handler from cycle cycles of the frame, until its RTS/RTI, a jump into the Kernal
+// interrupt exits or the budget. The sid writes are queued with their cycle in the frame. Returns the
+// cycle the handler ended at, overran is set when it was cut off.
+unsigned int SidPlayer::runHandler(uint16_t address, unsigned int cycles, unsigned int budget, bool *overran)
+{
+  static const unsigned short kernal_exit[] = { 0xea31, 0xea81, 0xfebc };
+  const int exit_count = sizeof(kernal_exit) / sizeof(kernal_exit[0]);
+
+  initcpu(&cpu, address, 0, 0, 0);
+  cpu.cpucycles = cycles;
+  for (;;)
   {
-    instr++;
-    if (instr > MAX_INSTR)
+    if (cycles >= budget)
     {
-      printf("Error: CPU executed abnormally high amount of instructions in playroutine, exiting\n");
-      playing = false;
-      return 1;
+      *overran = true;
+      break;
+    }
+
+    unsigned int used;
+    int result = run_until_return(&cpu, budget - cycles, kernal_exit, exit_count, &used);
+    cycles += used;
+
+    if (result == CPU_BUDGET || result == CPU_IDLE)
+    {
+      *overran = true;
+      break;
     }
-    // Test for jump into Kernal interrupt handler exit
-    if ((mem[0x01] & 0x07) != 0x5 && (pc == 0xea31 || pc == 0xea81))
+    // The Kernal exit only counts when the Kernal is banked in, otherwise
+    // step over the address and go on
+    if (result != CPU_EXIT_PC || (peek(0x01) & 0x07) != 0x5)
       break;
+    used = cpu.cpucycles;
+    if (!runcpu(&cpu))
+      break;
+    cycles += cpu.cpucycles - used;
+    if ((peek(0x01) & 0x07) != 0x5)
+    {
+      int e = 0;
+      while (e < exit_count && cpu.pc != kernal_exit[e])
+        e++;
+      if (e < exit_count)
+        break;
+    }
   }
+  return cycles;
+}
 
-  // update sid with the latest values
-  for (int reg = 0; reg < 25; reg++)
-    sid->write(reg, mem[0xd400 + reg]);
+// Apply the queued timer and raster writes at their cycles, moving the timers on from cycle now
+void SidPlayer::replayTimerWrites(unsigned int *now)
+{
+  for (int e = 0; e < cpu.sidwrite_count; e++) {
+    const SidWrite &w = cpu.sidwrites[e];
+    if (!C64Timers::handles(w.address))
+      continue;
+    if (w.cycle > *now) {
+      timers.advance(w.cycle - *now);
+      *now = w.cycle;
+    }
+    timers.write(w.address, w.value);
+  }
+}
 
-  // // check timing, update samples_per_frame as needed.
-  if ((mem[1]&3) && meta.timermode[meta.currentsong-1])
-    setFramePeriod((mem[0xdc05] << 8) | mem[0xdc04]); // use dynamic CIA settings
+// Count a frame cut off at the cycle budget, and degrade the tune after overrun_limit of them in a row
+void SidPlayer::overrun()
+{
+  overruns++;
+  if (++overrun_run < cfg.overrun_limit)
+    return;
+  overrun_run = 0;
 
-  return 0;
+  switch (cfg.overrun_policy) {
+    case OVERRUN_SKIP_FRAME:
+      skip_frame = true;
+      break;
+    case OVERRUN_HALF_SPEED:
+      if (!half_speed)
+        printf("Warning: playroutine overruns its frame, playing at half speed\n");
+      half_speed = true;
+      break;
+    case OVERRUN_STOP:
+      printf("Error: playroutine overruns its frame, stopping\n");
+      playing = false;
+      break;
+  }
 }
 
-/// fill the data with 2 channels
-size_t SidPlayer::read(uint8_t *buffer)
+// Stop the tune once it stored to a page the pool had no room for, it would play wrong from then on
+bool SidPlayer::checkMemory()
 {
-  size_t result = 0;
+#ifdef MOS6502_PAGED_MEMORY
+  if (cpu.pool_full) {
+    printf("Error: tune stores to more than %d pages of memory, PAGE_POOL_SIZE is too small, stopping\n", PAGE_POOL_SIZE);
+    playing = false;
+    return false;
+  }
+#endif
+  return true;
+}
 
-  if (!playing)
-    return result;
+#ifdef MOS6502_PROFILE
+void SidPlayer::startProfile(PcProfile *pcs, uint16_t base, uint32_t size)
+{
+  memset(&frame_profile, 0, sizeof(frame_profile));
+  if (pcs)
+    memset(pcs, 0, size * sizeof(PcProfile));
+  pc_profile = pcs;
+  pc_profile_base = base;
+  pc_profile_size = pcs ? size : 0;
+  setprofile(&cpu, pc_profile, pc_profile_base, pc_profile_size);
+  profiling = true;
+}
 
-  int16_t *ptr = (int16_t *)buffer;
-  for (int j = 0; j < samples_per_frame; j++)	
-  {
-		sid->clock(delta_t);
-    int16_t sample = sid->output();
-    *ptr++ = sample;
-    *ptr++ = sample;
-    result += 4;
+void SidPlayer::stopProfile()
+{
+  setprofile(&cpu, nullptr, 0, 0);
+  profiling = false;
+}
+
+void SidPlayer::reportProfile(void (*print)(const char *line, void *ref), void *ref, int top)
+{
+  const int MAX_TOP = 32;
+  const FrameProfile &f = frame_profile;
+  uint32_t average = f.frames ? f.cycles / f.frames : 0;
+  char line[128];
+
+  snprintf(line, sizeof(line), "%lu frames, %lu cycles on average, worst %lu in frame %lu (%.1f%% of the frame)\n",
+           (unsigned long)f.frames, (unsigned long)average, (unsigned long)f.worst, (unsigned long)f.worst_frame,
+           f.worst * 100.0f / frame_period_us);
+  print(line, ref);
+  if (!pc_profile)
+    return;
+
+  // Pick the top instructions by cycles with an insertion sort
+  uint32_t best[MAX_TOP];
+  uint64_t total = 0;
+  int count = 0;
+
+  top = top < MAX_TOP ? top : MAX_TOP;
+  for (uint32_t i = 0; i < pc_profile_size; i++) {
+    const PcProfile &p = pc_profile[i];
+    total += p.cycles;
+    if (!p.hits || (count == top && p.cycles <= pc_profile[best[top - 1]].cycles))
+      continue;
+    int j = count < top ? count++ : top - 1;
+    while (j > 0 && pc_profile[best[j - 1]].cycles < p.cycles) {
+      best[j] = best[j - 1];
+      j--;
+    }
+    best[j] = i;
+  }
+
+  print("  pc         cycles       hits  per frame  share\n", ref);
+  for (int n = 0; n < count; n++) {
+    const PcProfile &p = pc_profile[best[n]];
+    snprintf(line, sizeof(line), "  $%04lX %10lu %10lu %10.1f %5.1f%%\n", (unsigned long)(pc_profile_base + best[n]),
+             (unsigned long)p.cycles, (unsigned long)p.hits, f.frames ? (float)p.cycles / f.frames : 0.0f,
+             total ? p.cycles * 100.0f / total : 0.0f);
+    print(line, ref);
   }
-  return result;
 }
+
+void SidPlayer::reportProfile(FILE *file, int top)
+{
+  reportProfile([](const char *line, void *ref) { fputs(line, (FILE *)ref); }, file, top);
+}
+#endif
+
+// Apply a queued write to the chip mapped at its address, writes to other addresses are ignored
+void SidPlayer::applyWrite(const SidWrite &w)
+{
+  for (int i = 0; i < mixer.count(); i++) {
+    uint reg = w.address - meta.sidaddress[i];
+    if (reg < 25) {
+      mixer.get(i)->write(reg, w.value);
+      return;
+    }
+  }
+}
+
+// Apply the remaining queued writes at once, then the final register values in case the queue overflowed
+void SidPlayer::flushWrites()
+{
+  for (int e = 0; e < cpu.sidwrite_count; e++)
+    applyWrite(cpu.sidwrites[e]);
+  cpu.sidwrite_count = 0;
+
+  for (int i = 0; i < mixer.count(); i++)
+    mixer.get(i)->write_block(at(meta.sidaddress[i]));
+}
+
+// Render one frame, applying each queued sid write at its cycle in the frame.
+// The frame is rendered in segments between the writes, the block clock carries the
+// fractional sample position across them.
+size_t SidPlayer::render(int16_t *buffer, bool stereo)
+{
+  cycle_count done = 0;
+  size_t frames = 0;
+  int channels = stereo ? 2 : 1;
+
+  for (int e = 0; e < cpu.sidwrite_count; e++) {
+    const SidWrite &w = cpu.sidwrites[e];
+    cycle_count at = w.cycle < (unsigned)frame_period_us ? w.cycle : frame_period_us;
+
+    if (at > done) {
+      if (stereo)
+        frames += mixer.readStereo(at - done, buffer + frames * channels, samples_per_frame - frames);
+      else
+        frames += mixer.readMono(at - done, buffer + frames * channels, samples_per_frame - frames);
+      done = at;
+    }
+    applyWrite(w);
+  }
+  flushWrites();
+
+  if (stereo)
+    frames += mixer.readStereo(frame_period_us - done, buffer + frames * channels, samples_per_frame - frames);
+  else
+    frames += mixer.readMono(frame_period_us - done, buffer + frames * channels, samples_per_frame - frames);
+
+  return frames;
+}
+
+/// render one frame of mono samples, returns the number of samples
+size_t SidPlayer::readMono(int16_t *buffer)
+{
+  if (!playing)
+    return 0;
+
+  return render(buffer, false);
+}
+
+/// fill the data with 2 channels, mixed and panned by the sid mixer
+size_t SidPlayer::read(uint8_t *buffer)
+{
+  if (!playing)
+    return 0;
+
+  return render((int16_t *)buffer, true) * 4;
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "SidTools.h"
+#include <atomic>
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+#ifndef PREFETCH_CHUNK
+#define PREFETCH_CHUNK 4096     // bytes read per prefetch step
+#endif
+
+// Plays a list of sid files one after the other without a gap between them. While a tune plays,
+// the next one is read into a spare buffer and its header parsed, PREFETCH_CHUNK bytes per step().
+// On ESP32 the steps can run on a task of their own, elsewhere step() is called from loop() between
+// frames. playNext() then loads the tune from the buffer, which the player uses in place, so the
+// switch does not touch the card.
+// The entries are opened with a function given to begin(), which returns a source for an entry or
+// nullptr. The sources are deleted once read. With a task running, the entries are opened and read
+// on that task.
+class SidPlaylist
+{
+public:
+	typedef SidSource *(*Opener)(int index, void *ref);
+
+	// Files of up to buffer_size bytes can be played, two buffers of that size are allocated
+	SidPlaylist(SidPlayer *player, uint32_t buffer_size = 0x8000);
+	~SidPlaylist();
+
+	void begin(int count, Opener open, void *ref = nullptr);
+
+	// Play entry index, or the first playable entry after it, and start prefetching the entry after
+	// that. Returns false when no entry can be played.
+	bool play(int index);
+	bool playNext() { return play(current + 1 < count ? current + 1 : 0); }
+
+	// Run the next step of the prefetch, returns whether there was anything to do
+	bool step();
+
+#if defined(ESP32)
+	// Run the prefetch on a task of the given priority and core instead of from step()
+	bool startTask(int priority = 1, int core = 0);
+#endif
+
+	int getCurrent() { return current; }
+	int getCount() { return count; }
+
+	// The header of the prefetched entry once it has been read, otherwise nullptr
+	const SIDMetadata *getNextMeta() { return state == READY ? &next_meta : nullptr; }
+
+private:
+	enum { IDLE, REQUESTED, FETCHING, READY, FAILED };
+
+	SidPlayer *player;
+	uint8_t *buffers[2];
+	uint32_t buffer_size;
+	int spare;								// buffer the prefetch reads into, the player uses the other one
+
+	Opener open;
+	void *ref;
+	int count;
+	int current;
+
+	// The prefetch, owned by whoever runs step() from REQUESTED up to READY or FAILED
+	std::atomic<int> state;
+	int fetch_index;
+	SidSource *source;
+	uint32_t fetch_size;
+	uint32_t fetched;
+	SIDMetadata next_meta;
+
+	void fetch(int index);
+	int finishFetch();
+	void endFetch(int result);
+
+#if defined(ESP32)
+	std::atomic<bool> task_running;
+	std::atomic<bool> stopping;
+	static void prefetchTask(void *ref);
+#endif
+};
+
+SidPlaylist::SidPlaylist(SidPlayer *player, uint32_t buffer_size)
+{
+  this->player = player;
+  this->buffer_size = buffer_size;
+  buffers[0] = new uint8_t[buffer_size];
+  buffers[1] = new uint8_t[buffer_size];
+  spare = 0;
+  open = nullptr;
+  ref = nullptr;
+  count = 0;
+  current = -1;
+  state = IDLE;
+  fetch_index = -1;
+  source = nullptr;
+#if defined(ESP32)
+  task_running = false;
+  stopping = false;
+#endif
+}
+
+SidPlaylist::~SidPlaylist()
+{
+#if defined(ESP32)
+  stopping = true;
+  while (task_running)
+    vTaskDelay(1);
+#endif
+  player->stop();
+  delete source;
+  delete[] buffers[0];
+  delete[] buffers[1];
+}
+
+void SidPlaylist::begin(int count, Opener open, void *ref)
+{
+  finishFetch();
+  this->count = count;
+  this->open = open;
+  this->ref = ref;
+  current = -1;
+  state = IDLE;
+}
+
+bool SidPlaylist::play(int index)
+{
+  for (int tries = 0; tries < count; tries++, index = index + 1 < count ? index + 1 : 0) {
+    int result = finishFetch();
+    if (result == IDLE || fetch_index != index) {
+      fetch(index);
+      result = finishFetch();
+    }
+    if (result != READY) {
+      printf("Playlist: skipping entry %d\n", index);
+      continue;
+    }
+
+    // The current tune goes away with the load, its buffer becomes the spare one
+    MemorySidSource tune(buffers[spare], fetch_size);
+    player->stop();
+    if (!player->load(&tune, true)) {
+      printf("Playlist: skipping entry %d\n", index);
+      continue;
+    }
+    printf("Playlist: entry %d, %s by %s\n", index, player->meta.name, player->meta.author);
+    player->play();
+
+    current = index;
+    spare ^= 1;
+    fetch(index + 1 < count ? index + 1 : 0);
+    return true;
+  }
+  return false;
+}
+
+// Start reading entry index into the spare buffer, no prefetch may be running
+void SidPlaylist::fetch(int index)
+{
+  fetch_index = index;
+  state = REQUESTED;
+}
+
+// Wait for the prefetch to end, running it here unless a task runs it. Returns how it ended.
+int SidPlaylist::finishFetch()
+{
+  for (;;) {
+    int s = state;
+    if (s != REQUESTED && s != FETCHING)
+      return s;
+#if defined(ESP32)
+    if (task_running) {
+      vTaskDelay(1);
+      continue;
+    }
+#endif
+    step();
+  }
+}
+
+void SidPlaylist::endFetch(int result)
+{
+  delete source;
+  source = nullptr;
+  state = result;
+}
+
+bool SidPlaylist::step()
+{
+  int s = state;
+
+  if (s == REQUESTED) {
+    source = open ? open(fetch_index, ref) : nullptr;
+    fetch_size = source && source->isOpen() ? source->size() : 0;
+    fetched = 0;
+    if (fetch_size < (uint32_t)SidPlayer::HEADER_SIZE || fetch_size > buffer_size) {
+      printf("Playlist: entry %d can not be read, or is larger than %lu bytes\n", fetch_index, (unsigned long)buffer_size);
+      endFetch(FAILED);
+    } else {
+      state = FETCHING;
+    }
+    return true;
+  }
+  if (s != FETCHING)
+    return false;
+
+  uint32_t n = fetch_size - fetched < PREFETCH_CHUNK ? fetch_size - fetched : PREFETCH_CHUNK;
+  if (source->read(fetched, buffers[spare] + fetched, n) != n) {
+    printf("Playlist: read error in entry %d\n", fetch_index);
+    endFetch(FAILED);
+    return true;
+  }
+  fetched += n;
+
+  // Parse the header of a complete file, the player can't play Compute! Sidplayer data
+  if (fetched == fetch_size) {
+    SidPlayer::parseHeader(buffers[spare], &next_meta);
+    bool sid = !memcmp(next_meta.magicID, "PSID", 4) || !memcmp(next_meta.magicID, "RSID", 4);
+    bool mus = next_meta.magicID[0] == 'P' && (next_meta.flags & 0x01);
+    endFetch(sid && !mus ? READY : FAILED);
+  }
+  return true;
+}
+
+#if defined(ESP32)
+bool SidPlaylist::startTask(int priority, int core)
+{
+  if (task_running)
+    return true;
+
+  stopping = false;
+  task_running = true;
+  if (xTaskCreatePinnedToCore(prefetchTask, "sid prefetch", 4096, this, priority, nullptr, core) != pdPASS) {
+    task_running = false;
+    return false;
+  }
+  return true;
+}
+
+// Step the prefetch a chunk per tick, and look for a new one every 10ms when there is nothing to do
+void SidPlaylist::prefetchTask(void *ref)
+{
+  SidPlaylist *self = (SidPlaylist *)ref;
+
+  while (!self->stopping)
+    vTaskDelay(self->step() ? 1 : pdMS_TO_TICKS(10));
+
+  self->task_running = false;
+  vTaskDelete(nullptr);
+}
+#endif
@@ -7,6 +7,7 @@ typedef struct{
     int sid_model;
     int clockfreq;
 		float framerate;
+    sampling_method sampling;
     unsigned char *song_data;
     int song_length;		
 } SidRegPlayerConfig;
@@ -19,20 +20,25 @@ public:
 	void begin(SidRegPlayerConfig *cfg);
 
 	inline void setreg(int ofs, int val) { sid->write(ofs, val); }
+	// Applies a dump of the 25 sid registers, only changed registers are written
+	inline void setregs(const uint8_t *regs) { sid->write_block(regs); }
 	inline uint8_t getreg(int ofs) { return sid->read(ofs); }
 	void reset(void);
 	void stop(void);
 	inline bool isPlaying(void) { return playing; }	
 	size_t read(uint8_t *buffer, size_t bytes);
+	size_t readMono(int16_t *buffer);
 
 	// Provides/sets the current frame period in us
 	long getFramePeriod() { return(frame_period_us); }
 	void setFramePeriod(long period_us) {
 		frame_period_us = period_us;
-		samples_per_frame = round((float)config->samplerate / ((float)config->clockfreq/frame_period_us));
+		// The fixed point resampler carries the fractional cycles between frames,
+		// so a frame yields either floor or ceil of the exact sample count.
+		samples_per_frame = (int64_t)frame_period_us * config->samplerate / config->clockfreq + 1;
 	}
 
-	// Provides the number of samples per frame
+	// Provides the maximum number of samples rendered per frame
 	long getSamplesPerFrame() { return(samples_per_frame); }
 
 private:
@@ -45,7 +51,7 @@ private:
 	
 	cycle_count delta_t;					// ratio between system clk and samplerate, ie CLOCKFREQ / SAMPLERATE
 	long frame_period_us = 20000;	// raster line time in ms(PAL = 1000/50Hz = 20000 us)
-	int samples_per_frame = 441; 	// samplerate / framerate
+	int samples_per_frame = 441; 	// upper bound of samples rendered per frame
 
 	volatile bool playing;
 	SID *sid;
@@ -57,13 +63,14 @@ void SidRegPlayer::setDefaultConfig(SidRegPlayerConfig *cfg) {
   cfg->sid_model = SID_MODEL;
   cfg->clockfreq = CLOCKFREQ;
 	cfg->framerate = PAL_FRAMERATE;
+	cfg->sampling = SAMPLE_FAST;
 }
 
 void SidRegPlayer::begin(SidRegPlayerConfig *cfg)
 {
 	config = cfg;
 	this->reset();
-	sid->set_sampling_parameters(config->clockfreq, SAMPLE_FAST, config->samplerate); 
+	sid->set_sampling_parameters(config->clockfreq, config->sampling, config->samplerate); 
 	delta_t = config->clockfreq / config->samplerate;
 
 	setFramePeriod(cfg->clockfreq / cfg->framerate);
@@ -90,22 +97,31 @@ void SidRegPlayer::stop(void)
 	playing = false;	
 }
 
+/// render one frame of mono samples, returns the number of samples
+size_t SidRegPlayer::readMono(int16_t *buffer)
+{
+  if (!playing)
+    return 0;
+
+  cycle_count cycles = frame_period_us;
+  return sid->clock(cycles, buffer, samples_per_frame);
+}
+
 /// fill the data with 2 channels
 size_t SidRegPlayer::read(uint8_t *buffer, size_t bytes)
 {
-  size_t result = 0;
+  int16_t *ptr = (int16_t *)buffer;
 
-  if (!playing)
-    return result;
+  // Render the mono block into the upper half of the buffer and expand it
+  // in place; the write position never overtakes the read position.
+  int16_t *mono = ptr + samples_per_frame;
+  size_t samples = readMono(mono);
 
-  int16_t *ptr = (int16_t *)buffer;
-  for (int j = 0; j < samples_per_frame; j++)	
+  for (size_t j = 0; j < samples; j++)
   {
-		sid->clock(delta_t);
-    int16_t sample = sid->output();
+    int16_t sample = mono[j];
     *ptr++ = sample;
     *ptr++ = sample;
-    result += 4;
   }
-  return result;
+  return samples * 4;
 }
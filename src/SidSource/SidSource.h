@@ -0,0 +1,127 @@
+#pragma once
+
+#include "SidTools.h"
+#include "SDFat.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SIDSOURCE_POSIX 1
+#endif
+
+// Where SidPlayer::load() reads a sid file from. The loader asks for the header and for the whole
+// payload in one read each. A source that holds the file in memory returns it from data(), the
+// tune is then used in place and nothing is copied.
+class SidSource
+{
+public:
+	virtual ~SidSource() {}
+
+	// Whether the file could be opened
+	virtual bool isOpen() { return true; }
+
+	// Size of the file in bytes
+	virtual uint32_t size() = 0;
+
+	// Read up to n bytes from offset into buffer, returns the number of bytes read
+	virtual uint32_t read(uint32_t offset, uint8_t *buffer, uint32_t n) = 0;
+
+	// The whole file when it is in memory, valid as long as the tune is loaded
+	virtual const uint8_t *data() { return nullptr; }
+};
+
+// A file opened with SdFat. SdFat reads the sectors of a large read straight into the buffer.
+class SdFatSidSource : public SidSource
+{
+public:
+	SdFatSidSource(StreamFile<FatFile, uint32_t> *file) { this->file = file; }
+
+	// Open the file at path on the current volume, it is closed along with the source
+	SdFatSidSource(const char *path) { file = &own_file; own_file.open(path); }
+	~SdFatSidSource() { if (file == &own_file && own_file.isOpen()) own_file.close(); }
+
+	bool isOpen() { return file->isOpen(); }
+
+	uint32_t size() { return file->size(); }
+	uint32_t read(uint32_t offset, uint8_t *buffer, uint32_t n);
+
+private:
+	StreamFile<FatFile, uint32_t> *file;
+	StreamFile<FatFile, uint32_t> own_file;
+};
+
+uint32_t SdFatSidSource::read(uint32_t offset, uint8_t *buffer, uint32_t n)
+{
+  if (!file->seekSet(offset))
+    return 0;
+
+  int count = file->read(buffer, n);
+  return count > 0 ? count : 0;
+}
+
+// A file in memory, eg in flash or embedded in the sketch
+class MemorySidSource : public SidSource
+{
+public:
+	MemorySidSource(const uint8_t *data, uint32_t size) { file = data; file_size = size; }
+
+	uint32_t size() { return file_size; }
+	uint32_t read(uint32_t offset, uint8_t *buffer, uint32_t n);
+	const uint8_t *data() { return file; }
+
+private:
+	const uint8_t *file;
+	uint32_t file_size;
+};
+
+uint32_t MemorySidSource::read(uint32_t offset, uint8_t *buffer, uint32_t n)
+{
+  if (offset >= file_size)
+    return 0;
+  if (n > file_size - offset)
+    n = file_size - offset;
+  memcpy(buffer, file + offset, n);
+  return n;
+}
+
+#ifdef SIDSOURCE_POSIX
+// A file on a POSIX host, so tunes load on the desktop the way they load from the card
+class PosixSidSource : public SidSource
+{
+public:
+	PosixSidSource(const char *path) { fd = open(path, O_RDONLY); }
+	~PosixSidSource() { if (fd >= 0) close(fd); }
+
+	bool isOpen() { return fd >= 0; }
+
+	uint32_t size();
+	uint32_t read(uint32_t offset, uint8_t *buffer, uint32_t n);
+
+private:
+	int fd;
+};
+
+uint32_t PosixSidSource::size()
+{
+  struct stat st;
+
+  if (fd < 0 || fstat(fd, &st) < 0)
+    return 0;
+  return st.st_size;
+}
+
+uint32_t PosixSidSource::read(uint32_t offset, uint8_t *buffer, uint32_t n)
+{
+  uint32_t done = 0;
+
+  // pread() may return less than asked for, eg when interrupted
+  while (fd >= 0 && done < n) {
+    ssize_t count = pread(fd, buffer + done, n - done, offset + done);
+    if (count <= 0)
+      break;
+    done += count;
+  }
+  return done;
+}
+#endif
@@ -8,7 +8,11 @@
 #include "reSID/wave.cc"
 #include "reSID/sid.cc"
 
+#include "SidMixer/SidMixer.h"
 #include "SidRegPlayer/SidRegPlayer.h"
 #include "Mos6502/mos6502.h"
+#include "C64Timers/C64Timers.h"
+#include "SidSource/SidSource.h"
 #include "SidPlayer/SidPlayer.h"
+#include "SidPlaylist/SidPlaylist.h"
 #include "ButtonActions/ButtonActions.h"
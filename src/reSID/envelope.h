@@ -78,7 +78,7 @@ protected:
   // The 16 selectable sustain levels.
   static const reg8 sustain_level[];
 
-friend class SID;
+template<chip_model> friend class SIDChip;
 };
 
 
@@ -215,6 +215,32 @@ void EnvelopeGenerator::clock(cycle_count delta_t)
       return;
     }
 
+#if RESID_SKIP_AHEAD
+    // Skip ahead when the envelope counter is frozen, i.e. at zero or at the
+    // sustain level. Only the rate and exponential counters advance then,
+    // which can be done in closed form for all remaining rate periods.
+    if ((hold_zero
+	 || (state == DECAY_SUSTAIN
+	     && envelope_counter == sustain_level[sustain]
+	     && envelope_counter != 0x00
+	     && (envelope_counter != 0xff || exponential_counter_period == 1)))
+	&& exponential_counter < exponential_counter_period)
+    {
+      delta_t -= rate_step;
+      cycle_count rate_steps = delta_t/rate_period + 1;
+      rate_counter = delta_t%rate_period;
+
+      if (state == ATTACK) {
+	exponential_counter = 0;
+      }
+      else {
+	exponential_counter =
+	  (exponential_counter + rate_steps)%exponential_counter_period;
+      }
+      return;
+    }
+#endif
+
     rate_counter = 0;
     delta_t -= rate_step;
 
@@ -25,22 +25,20 @@ RESID_NAMESPACE_START
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
-ExternalFilter::ExternalFilter()
+template<chip_model model>
+ExternalFilter<model>::ExternalFilter()
 {
   reset();
   enable_filter(true);
   set_sampling_parameter(15915.6);
-  //set_chip_model(MOS6581);
-	{//instead:
-	mixer_DC = ((((0x800 - 0x380) + 0x800)*0xff*3 - 0xfff*0xff/18) >> 7)*0x0f;
-	}
 }
 
 
 // ----------------------------------------------------------------------------
 // Enable filter.
 // ----------------------------------------------------------------------------
-void ExternalFilter::enable_filter(bool enable)
+template<chip_model model>
+void ExternalFilter<model>::enable_filter(bool enable)
 {
   enabled = enable;
 }
@@ -49,7 +47,8 @@ void ExternalFilter::enable_filter(bool enable)
 // ----------------------------------------------------------------------------
 // Setup of the external filter sampling parameters.
 // ----------------------------------------------------------------------------
-void ExternalFilter::set_sampling_parameter(float pass_freq)
+template<chip_model model>
+void ExternalFilter<model>::set_sampling_parameter(float pass_freq)
 {
   static const float pi = 3.1415926535897932385;
 
@@ -66,28 +65,32 @@ void ExternalFilter::set_sampling_parameter(float pass_freq)
 
 
 // ----------------------------------------------------------------------------
-// Set chip model.
+// Check whether the filter has settled.
+// The longest step has the largest coefficients, if it does not change the
+// state for input Vi then no shorter step will.
 // ----------------------------------------------------------------------------
-/*
-void ExternalFilter::set_chip_model(chip_model model)
+template<chip_model model>
+bool ExternalFilter<model>::settled(cycle_count delta_t, sound_sample Vi)
 {
-  if (model == MOS6581) {
-    // Maximum mixer DC output level; to be removed if the external
-    // filter is turned off: ((wave DC + voice DC)*voices + mixer DC)*volume
-    // See voice.cc and filter.cc for an explanation of the values.
-    mixer_DC = ((((0x800 - 0x380) + 0x800)*0xff*3 - 0xfff*0xff/18) >> 7)*0x0f;
+  if (!enabled) {
+    return Vo == Vi - mixer_DC;
   }
-  else {
-    // No DC offsets in the MOS8580.
-    mixer_DC = 0;
+
+  if (delta_t > 8) {
+    delta_t = 8;
   }
+
+  return Vo == Vlp - Vhp
+    && !((w0lp*delta_t >> 8)*(Vi - Vlp) >> 12)
+    && !(w0hp*delta_t*(Vlp - Vhp) >> 20);
 }
-*/
+
 
 // ----------------------------------------------------------------------------
 // SID reset.
 // ----------------------------------------------------------------------------
-void ExternalFilter::reset()
+template<chip_model model>
+void ExternalFilter<model>::reset()
 {
   // State of filter.
   Vlp = 0;
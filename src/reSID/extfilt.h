@@ -36,7 +36,11 @@ RESID_NAMESPACE_START
 // additional low-pass and high-pass 3dB-frequencies in the order of hundreds
 // of kHz. This calls for a sampling frequency of several MHz, which is far
 // too high for practical use.
+//
+// The chip model is a template parameter, the MOS8580 has no DC offsets to
+// remove when the filter is disabled.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 class ExternalFilter
 {
 public:
@@ -44,12 +48,15 @@ public:
 
   void enable_filter(bool enable);
   void set_sampling_parameter(float pass_freq);
-  //void set_chip_model(chip_model model);
 
   RESID_INLINE void clock(sound_sample Vi);
   RESID_INLINE void clock(cycle_count delta_t, sound_sample Vi);
   void reset();
 
+  // True if clocking with input Vi in steps of up to delta_t cycles leaves
+  // the filter state as is.
+  bool settled(cycle_count delta_t, sound_sample Vi);
+
   // Audio output (20 bits).
   RESID_INLINE sound_sample output();
 
@@ -57,8 +64,11 @@ protected:
   // Filter enabled.
   bool enabled;
 
-  // Maximum mixer DC offset.
-  sound_sample mixer_DC;
+  // Maximum mixer DC output level; to be removed if the external
+  // filter is turned off: ((wave DC + voice DC)*voices + mixer DC)*volume
+  // See voice.cc and filter.cc for an explanation of the values.
+  static const sound_sample mixer_DC = model == MOS6581 ?
+    ((((0x800 - 0x380) + 0x800)*0xff*3 - 0xfff*0xff/18) >> 7)*0x0f : 0;
 
   // State of filters.
   sound_sample Vlp; // lowpass
@@ -69,7 +79,7 @@ protected:
   sound_sample w0lp;
   sound_sample w0hp;
 
-friend class SID;
+template<chip_model> friend class SIDChip;
 };
 
 
@@ -84,8 +94,9 @@ friend class SID;
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void ExternalFilter::clock(sound_sample Vi)
+void ExternalFilter<model>::clock(sound_sample Vi)
 {
   // This is handy for testing.
   if (!enabled) {
@@ -113,9 +124,10 @@ void ExternalFilter::clock(sound_sample Vi)
 // ----------------------------------------------------------------------------
 // SID clocking - delta_t cycles.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void ExternalFilter::clock(cycle_count delta_t,
-			   sound_sample Vi)
+void ExternalFilter<model>::clock(cycle_count delta_t,
+				  sound_sample Vi)
 {
   // This is handy for testing.
   if (!enabled) {
@@ -156,8 +168,9 @@ void ExternalFilter::clock(cycle_count delta_t,
 // ----------------------------------------------------------------------------
 // Audio output (19.5 bits).
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-sound_sample ExternalFilter::output()
+sound_sample ExternalFilter<model>::output()
 {
   return Vo;
 }
@@ -40,7 +40,9 @@ RESID_NAMESPACE_START
 // FC setting.
 //
 // The mapping function is specified with spline interpolation points and
-// the function values are retrieved via table lookup.
+// the function values are retrieved via table lookup. The tables in
+// filter6581.h and filter8580.h are the points below interpolated with
+// spline.h at a resolution of 1.
 //
 // NB! Cutoff frequency characteristics may vary, we have modeled two
 // particular Commodore 64s.
@@ -112,7 +114,8 @@ const fc_point SidFilter::f0_points_8580[] =
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
-SidFilter::SidFilter()
+template<chip_model model>
+SidFilter<model>::SidFilter()
 {
   fc = 0;
 
@@ -133,81 +136,48 @@ SidFilter::SidFilter()
   Vnf = 0;
 
   enable_filter(true);
-/*	
-  // Create mappings from FC to cutoff frequency.
-  interpolate(f0_points_6581, f0_points_6581
-	      + sizeof(f0_points_6581)/sizeof(*f0_points_6581) - 1,
-	      PointPlotter<sound_sample>(f0_6581), 1.0);
-			
-  interpolate(f0_points_8580, f0_points_8580
-	      + sizeof(f0_points_8580)/sizeof(*f0_points_8580) - 1,
-	      PointPlotter<sound_sample>(f0_8580), 1.0);
-*/
-//  set_chip_model(MOS6581);
-{//instead:
-	    mixer_DC = -0xfff*0xff/18 >> 7;
-
-    //f0 = f0_6581;
-   // f0_points = f0_points_6581;		
-   // f0_count = sizeof(f0_points_6581)/sizeof(*f0_points_6581);
-		set_w0();
-    set_Q();
-}
-		
+
+  set_w0();
+  set_Q();
 }
 
 
 // ----------------------------------------------------------------------------
 // Enable SidFilter.
 // ----------------------------------------------------------------------------
-void SidFilter::enable_filter(bool enable)
+template<chip_model model>
+void SidFilter<model>::enable_filter(bool enable)
 {
   enabled = enable;
 }
 
 
 // ----------------------------------------------------------------------------
-// Set chip model.
+// Chip model DC level, see mixer_DC in filter.h.
+//
+// MOS6581:
+//
+// The mixer has a small input DC offset. This is found as follows:
+//
+// The "zero" output level of the mixer measured on the SID audio
+// output pin is 5.50V at zero volume, and 5.44 at full
+// volume. This yields a DC offset of (5.44V - 5.50V) = -0.06V.
+//
+// The DC offset is thus -0.06V/1.05V ~ -1/18 of the dynamic range
+// of one voice. See voice.cc for measurement of the dynamic
+// range.
+//
+// MOS8580:
+//
+// No DC offsets in the MOS8580.
 // ----------------------------------------------------------------------------
-/*
-void SidFilter::set_chip_model(chip_model model)
-{
-  if (model == MOS6581) {
-    // The mixer has a small input DC offset. This is found as follows:
-    //
-    // The "zero" output level of the mixer measured on the SID audio
-    // output pin is 5.50V at zero volume, and 5.44 at full
-    // volume. This yields a DC offset of (5.44V - 5.50V) = -0.06V.
-    //
-    // The DC offset is thus -0.06V/1.05V ~ -1/18 of the dynamic range
-    // of one voice. See voice.cc for measurement of the dynamic
-    // range.
-
-    mixer_DC = -0xfff*0xff/18 >> 7;
-
-    f0 = f0_6581;
-    f0_points = f0_points_6581;
-    f0_count = sizeof(f0_points_6581)/sizeof(*f0_points_6581);
-  }
-  else {
-    // No DC offsets in the MOS8580.
-    mixer_DC = 0;
-
-    f0 = f0_8580;
-    f0_points = f0_points_8580;
-    f0_count = sizeof(f0_points_8580)/sizeof(*f0_points_8580);
-  }
-
-  set_w0();
-  set_Q();
-}
-*/
 
 
 // ----------------------------------------------------------------------------
 // SID reset.
 // ----------------------------------------------------------------------------
-void SidFilter::reset()
+template<chip_model model>
+void SidFilter<model>::reset()
 {
   fc = 0;
 
@@ -232,22 +202,46 @@ void SidFilter::reset()
 }
 
 
+// ----------------------------------------------------------------------------
+// Check whether the filter has settled.
+// With constant input, the integrators have reached a fixpoint when neither
+// the 1 cycle step nor a delta_t cycle step changes them; Vhp is then
+// recomputed from unchanged values. Shorter delta steps can not move a
+// settled filter, since the arithmetic shifts only yield zero for a
+// non-negative product.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+bool SidFilter<model>::settled(cycle_count delta_t)
+{
+  if (delta_t > 8) {
+    delta_t = 8;
+  }
+  sound_sample w0_delta_t = w0_ceil_dt*delta_t >> 6;
+
+  return !(w0_ceil_1*Vhp >> 20) && !(w0_ceil_1*Vbp >> 20)
+    && !(w0_delta_t*Vhp >> 14) && !(w0_delta_t*Vbp >> 14);
+}
+
+
 // ----------------------------------------------------------------------------
 // Register functions.
 // ----------------------------------------------------------------------------
-void SidFilter::writeFC_LO(reg8 fc_lo)
+template<chip_model model>
+void SidFilter<model>::writeFC_LO(reg8 fc_lo)
 {
   fc = (fc & 0x7f8) | (fc_lo & 0x007);
   set_w0();
 }
 
-void SidFilter::writeFC_HI(reg8 fc_hi)
+template<chip_model model>
+void SidFilter<model>::writeFC_HI(reg8 fc_hi)
 {
   fc = (((unsigned int)fc_hi << 3) & 0x7f8) | (fc & 0x007);
   set_w0();
 }
 
-void SidFilter::writeRES_FILT(reg8 res_filt)
+template<chip_model model>
+void SidFilter<model>::writeRES_FILT(reg8 res_filt)
 {
   res = (res_filt >> 4) & 0x0f;
   set_Q();
@@ -255,7 +249,8 @@ void SidFilter::writeRES_FILT(reg8 res_filt)
   filt = res_filt & 0x0f;
 }
 
-void SidFilter::writeMODE_VOL(reg8 mode_vol)
+template<chip_model model>
+void SidFilter<model>::writeMODE_VOL(reg8 mode_vol)
 {
   voice3off = mode_vol & 0x80;
 
@@ -265,35 +260,30 @@ void SidFilter::writeMODE_VOL(reg8 mode_vol)
 }
 
 // Set SidFilter cutoff frequency.
-void SidFilter::set_w0()
+template<chip_model model>
+void SidFilter<model>::set_w0()
 {
-  const float pi = 3.1415926535897932385;
-
-  // Multiply with 1.048576 to facilitate division by 1 000 000 by right-
-  // shifting 20 times (2 ^ 20 = 1048576).
-  w0 = static_cast<sound_sample>(2.0*pi*f0[fc]*1.048576);
-
-  // Limit f0 to 16kHz to keep 1 cycle SidFilter stable.
-  const sound_sample w0_max_1 = static_cast<sound_sample>(2.0*pi*16000.0*1.048576);
-  w0_ceil_1 = w0 <= w0_max_1 ? w0 : w0_max_1;
-
-  // Limit f0 to 4kHz to keep delta_t cycle SidFilter stable.
-  const sound_sample w0_max_dt = static_cast<sound_sample>(2.0*pi*4000.0*1.048576);
-  w0_ceil_dt = w0 <= w0_max_dt ? w0 : w0_max_dt;
+  w0_ceil_1 = w0_ceil_1_table[fc];
+  w0_ceil_dt = w0_ceil_dt_table[fc];
 }
 
 // Set SidFilter resonance.
-void SidFilter::set_Q()
+// As resonance is increased, the SidFilter must be clocked more often to keep
+// stable.
+template<chip_model model>
+void SidFilter<model>::set_Q()
 {
-  // Q is controlled linearly by res. Q has approximate range [0.707, 1.7].
-  // As resonance is increased, the SidFilter must be clocked more often to keep
-  // stable.
-
-  // The coefficient 1024 is dispensed of later by right-shifting 10 times
-  // (2 ^ 10 = 1024).
-  _1024_div_Q = static_cast<sound_sample>(1024.0/(0.707 + 1.0*res/15.0));
+  _1024_div_Q = _1024_div_Q_table[res];
 }
 
+// Out of class definitions of the coefficient tables, required before C++17.
+template<chip_model model>
+constexpr sound_sample SidFilter<model>::w0_ceil_1_table[];
+template<chip_model model>
+constexpr sound_sample SidFilter<model>::w0_ceil_dt_table[];
+template<chip_model model>
+constexpr sound_sample SidFilter<model>::_1024_div_Q_table[];
+
 // ----------------------------------------------------------------------------
 // Spline functions.
 // ----------------------------------------------------------------------------
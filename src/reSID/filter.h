@@ -23,9 +23,71 @@
 #include "siddefs.h"
 //#include "spline.h"
 #include "filter6581.h"
+#include "filter8580.h"
 
 RESID_NAMESPACE_START
 
+// ----------------------------------------------------------------------------
+// Filter coefficients for a register value, evaluated by the compiler to
+// fill the coefficient tables of SidFilter below. The expressions are those
+// of the former set_w0() and set_Q(), in the same double precision.
+// ----------------------------------------------------------------------------
+constexpr double filter_2pi = 2.0*static_cast<float>(3.1415926535897932385);
+
+// Multiply with 1.048576 to facilitate division by 1 000 000 by right-
+// shifting 20 times (2 ^ 20 = 1048576).
+constexpr sound_sample filter_w0(double f0)
+{
+  return static_cast<sound_sample>(filter_2pi*f0*1.048576);
+}
+
+template<chip_model model>
+constexpr sound_sample filter_w0_ceil(int fc, double f_max)
+{
+  return filter_w0((model == MOS6581 ? filter6581 : filter8580)[fc]) <= filter_w0(f_max)
+    ? filter_w0((model == MOS6581 ? filter6581 : filter8580)[fc]) : filter_w0(f_max);
+}
+
+// Limit f0 to 16kHz to keep 1 cycle SidFilter stable.
+template<chip_model model>
+constexpr sound_sample filter_w0_ceil_1(int fc)
+{
+  return filter_w0_ceil<model>(fc, 16000.0);
+}
+
+// Limit f0 to 4kHz to keep delta_t cycle SidFilter stable.
+template<chip_model model>
+constexpr sound_sample filter_w0_ceil_dt(int fc)
+{
+  return filter_w0_ceil<model>(fc, 4000.0);
+}
+
+// Q is controlled linearly by res. Q has approximate range [0.707, 1.7].
+// The coefficient 1024 is dispensed of later by right-shifting 10 times
+// (2 ^ 10 = 1024).
+constexpr sound_sample filter_1024_div_Q(int res)
+{
+  return static_cast<sound_sample>(1024.0/(0.707 + 1.0*res/15.0));
+}
+
+// Table initializers, f(i) for i = start ... start + n - 1.
+#define RESID_TABLE_4(f, i) f(i), f(i + 1), f(i + 2), f(i + 3)
+#define RESID_TABLE_16(f, i) \
+  RESID_TABLE_4(f, i), RESID_TABLE_4(f, i + 4), \
+  RESID_TABLE_4(f, i + 8), RESID_TABLE_4(f, i + 12)
+#define RESID_TABLE_64(f, i) \
+  RESID_TABLE_16(f, i), RESID_TABLE_16(f, i + 16), \
+  RESID_TABLE_16(f, i + 32), RESID_TABLE_16(f, i + 48)
+#define RESID_TABLE_256(f, i) \
+  RESID_TABLE_64(f, i), RESID_TABLE_64(f, i + 64), \
+  RESID_TABLE_64(f, i + 128), RESID_TABLE_64(f, i + 192)
+#define RESID_TABLE_1024(f, i) \
+  RESID_TABLE_256(f, i), RESID_TABLE_256(f, i + 256), \
+  RESID_TABLE_256(f, i + 512), RESID_TABLE_256(f, i + 768)
+#define RESID_TABLE_2048(f, i) \
+  RESID_TABLE_1024(f, i), RESID_TABLE_1024(f, i + 1024)
+
+
 // ----------------------------------------------------------------------------
 // The SID filter is modeled with a two-integrator-loop biquadratic filter,
 // which has been confirmed by Bob Yannes to be the actual circuit used in
@@ -120,14 +182,17 @@ RESID_NAMESPACE_START
 // 
 //          Vw
 //
+//
+// The chip model is a template parameter, so that the mixer DC offset and the
+// cutoff frequency table are resolved at compile time.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 class SidFilter
 {
 public:
   SidFilter();
 
   void enable_filter(bool enable);
- // void set_chip_model(chip_model model);
 
   RESID_INLINE
   void clock(sound_sample voice1, sound_sample voice2, sound_sample voice3,
@@ -138,6 +203,10 @@ public:
 	     sound_sample ext_in);
   void reset();
 
+  // True if clocking with unchanged input in steps of 1 up to delta_t
+  // cycles leaves the filter state as is.
+  bool settled(cycle_count delta_t);
+
   // Write registers.
   void writeFC_LO(reg8);
   void writeFC_HI(reg8);
@@ -177,7 +246,8 @@ protected:
   reg4 vol;
 
   // Mixer DC offset.
-  sound_sample mixer_DC;
+  // See filter.cc for the MOS6581 measurement, the MOS8580 has no DC offsets.
+  static const sound_sample mixer_DC = model == MOS6581 ? -0xfff*0xff/18 >> 7 : 0;
 
   // State of filter.
   sound_sample Vhp; // highpass
@@ -186,23 +256,22 @@ protected:
   sound_sample Vnf; // not filtered
 
   // Cutoff frequency, resonance.
-  sound_sample w0, w0_ceil_1, w0_ceil_dt;
+  sound_sample w0_ceil_1, w0_ceil_dt;
   sound_sample _1024_div_Q;
 
-  // Cutoff frequency tables.
+  // Coefficient tables, indexed by the FC and RES registers.
   // FC is an 11 bit register.
-  //sound_sample f0_6581[2048];
-  //sound_sample f0_8580[2048];
-  //sound_sample* f0;
-	//const sound_sample* f0 = filter6581;
-	const short* f0 = filter6581;
-  //const static fc_point f0_points_6581[];
-		
-  //const static fc_point f0_points_8580[];
-  //const fc_point* f0_points;
-  //int f0_count;
-
-friend class SID;
+  static constexpr sound_sample w0_ceil_1_table[2048] = {
+    RESID_TABLE_2048(filter_w0_ceil_1<model>, 0)
+  };
+  static constexpr sound_sample w0_ceil_dt_table[2048] = {
+    RESID_TABLE_2048(filter_w0_ceil_dt<model>, 0)
+  };
+  static constexpr sound_sample _1024_div_Q_table[16] = {
+    RESID_TABLE_16(filter_1024_div_Q, 0)
+  };
+
+template<chip_model> friend class SIDChip;
 };
 
 
@@ -217,8 +286,9 @@ friend class SID;
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void SidFilter::clock(sound_sample voice1,
+void SidFilter<model>::clock(sound_sample voice1,
 		   sound_sample voice2,
 		   sound_sample voice3,
 		   sound_sample ext_in)
@@ -339,8 +409,9 @@ void SidFilter::clock(sound_sample voice1,
 // ----------------------------------------------------------------------------
 // SID clocking - delta_t cycles.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void SidFilter::clock(cycle_count delta_t,
+void SidFilter<model>::clock(cycle_count delta_t,
 		   sound_sample voice1,
 		   sound_sample voice2,
 		   sound_sample voice3,
@@ -480,8 +551,9 @@ void SidFilter::clock(cycle_count delta_t,
 // ----------------------------------------------------------------------------
 // SID audio output (20 bits).
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-sound_sample SidFilter::output()
+sound_sample SidFilter<model>::output()
 {
   // This is handy for testing.
   if (!enabled) {
@@ -0,0 +1,130 @@
+constexpr short filter8580[] = {
+0x0000, 0x0006, 0x000C, 0x0012, 0x0019, 0x001F, 0x0025, 0x002B, 0x0032, 0x0038, 0x003E, 0x0044, 0x004B, 0x0051, 0x0057, 0x005D, 
+0x0064, 0x006A, 0x0070, 0x0076, 0x007D, 0x0083, 0x0089, 0x008F, 0x0096, 0x009C, 0x00A2, 0x00A8, 0x00AF, 0x00B5, 0x00BB, 0x00C1, 
+0x00C8, 0x00CE, 0x00D4, 0x00DA, 0x00E1, 0x00E7, 0x00ED, 0x00F3, 0x00FA, 0x0100, 0x0106, 0x010C, 0x0113, 0x0119, 0x011F, 0x0125, 
+0x012C, 0x0132, 0x0138, 0x013E, 0x0145, 0x014B, 0x0151, 0x0157, 0x015E, 0x0164, 0x016A, 0x0170, 0x0177, 0x017D, 0x0183, 0x0189, 
+0x0190, 0x0196, 0x019C, 0x01A2, 0x01A9, 0x01AF, 0x01B5, 0x01BB, 0x01C2, 0x01C8, 0x01CE, 0x01D4, 0x01DB, 0x01E1, 0x01E7, 0x01ED, 
+0x01F4, 0x01FA, 0x0200, 0x0206, 0x020D, 0x0213, 0x0219, 0x021F, 0x0226, 0x022C, 0x0232, 0x0238, 0x023F, 0x0245, 0x024B, 0x0251, 
+0x0258, 0x025E, 0x0264, 0x026A, 0x0271, 0x0277, 0x027D, 0x0283, 0x028A, 0x0290, 0x0296, 0x029C, 0x02A3, 0x02A9, 0x02AF, 0x02B5, 
+0x02BC, 0x02C2, 0x02C8, 0x02CE, 0x02D5, 0x02DB, 0x02E1, 0x02E7, 0x02EE, 0x02F4, 0x02FA, 0x0300, 0x0307, 0x030D, 0x0313, 0x0319, 
+0x0320, 0x0326, 0x032C, 0x0332, 0x0338, 0x033F, 0x0345, 0x034B, 0x0351, 0x0358, 0x035E, 0x0364, 0x036A, 0x0370, 0x0376, 0x037D, 
+0x0383, 0x0389, 0x038F, 0x0395, 0x039B, 0x03A2, 0x03A8, 0x03AE, 0x03B4, 0x03BA, 0x03C0, 0x03C6, 0x03CD, 0x03D3, 0x03D9, 0x03DF, 
+0x03E5, 0x03EB, 0x03F1, 0x03F8, 0x03FE, 0x0404, 0x040A, 0x0410, 0x0416, 0x041C, 0x0422, 0x0429, 0x042F, 0x0435, 0x043B, 0x0441, 
+0x0447, 0x044D, 0x0453, 0x0459, 0x0460, 0x0466, 0x046C, 0x0472, 0x0478, 0x047E, 0x0484, 0x048B, 0x0491, 0x0497, 0x049D, 0x04A3, 
+0x04A9, 0x04AF, 0x04B6, 0x04BC, 0x04C2, 0x04C8, 0x04CE, 0x04D4, 0x04DB, 0x04E1, 0x04E7, 0x04ED, 0x04F3, 0x04FA, 0x0500, 0x0506, 
+0x050C, 0x0512, 0x0519, 0x051F, 0x0525, 0x052B, 0x0532, 0x0538, 0x053E, 0x0544, 0x054B, 0x0551, 0x0557, 0x055E, 0x0564, 0x056A, 
+0x0570, 0x0577, 0x057D, 0x0583, 0x058A, 0x0590, 0x0597, 0x059D, 0x05A3, 0x05AA, 0x05B0, 0x05B7, 0x05BD, 0x05C3, 0x05CA, 0x05D0, 
+0x05D7, 0x05DD, 0x05E4, 0x05EA, 0x05F1, 0x05F7, 0x05FE, 0x0604, 0x060B, 0x0611, 0x0618, 0x061E, 0x0625, 0x062C, 0x0632, 0x0639, 
+0x0640, 0x0646, 0x064D, 0x0654, 0x065A, 0x0661, 0x0668, 0x066E, 0x0675, 0x067C, 0x0683, 0x068A, 0x0690, 0x0697, 0x069E, 0x06A5, 
+0x06AC, 0x06B3, 0x06BA, 0x06C1, 0x06C8, 0x06CF, 0x06D6, 0x06DC, 0x06E3, 0x06EA, 0x06F2, 0x06F9, 0x0700, 0x0707, 0x070E, 0x0715, 
+0x071C, 0x0723, 0x072A, 0x0731, 0x0738, 0x073F, 0x0746, 0x074E, 0x0755, 0x075C, 0x0763, 0x076A, 0x0771, 0x0779, 0x0780, 0x0787, 
+0x078E, 0x0795, 0x079C, 0x07A4, 0x07AB, 0x07B2, 0x07B9, 0x07C0, 0x07C8, 0x07CF, 0x07D6, 0x07DD, 0x07E5, 0x07EC, 0x07F3, 0x07FA, 
+0x0802, 0x0809, 0x0810, 0x0817, 0x081E, 0x0826, 0x082D, 0x0834, 0x083B, 0x0843, 0x084A, 0x0851, 0x0858, 0x085F, 0x0867, 0x086E, 
+0x0875, 0x087C, 0x0883, 0x088A, 0x0892, 0x0899, 0x08A0, 0x08A7, 0x08AE, 0x08B5, 0x08BD, 0x08C4, 0x08CB, 0x08D2, 0x08D9, 0x08E0, 
+0x08E7, 0x08EE, 0x08F5, 0x08FC, 0x0903, 0x090A, 0x0911, 0x0919, 0x0920, 0x0927, 0x092D, 0x0934, 0x093B, 0x0942, 0x0949, 0x0950, 
+0x0957, 0x095E, 0x0965, 0x096C, 0x0973, 0x0979, 0x0980, 0x0987, 0x098E, 0x0995, 0x099B, 0x09A2, 0x09A9, 0x09AF, 0x09B6, 0x09BD, 
+0x09C4, 0x09CA, 0x09D1, 0x09D7, 0x09DE, 0x09E5, 0x09EB, 0x09F2, 0x09F8, 0x09FF, 0x0A05, 0x0A0C, 0x0A12, 0x0A19, 0x0A1F, 0x0A26, 
+0x0A2C, 0x0A33, 0x0A39, 0x0A40, 0x0A46, 0x0A4C, 0x0A53, 0x0A59, 0x0A60, 0x0A66, 0x0A6C, 0x0A73, 0x0A79, 0x0A80, 0x0A86, 0x0A8C, 
+0x0A93, 0x0A99, 0x0A9F, 0x0AA5, 0x0AAC, 0x0AB2, 0x0AB8, 0x0ABF, 0x0AC5, 0x0ACB, 0x0AD1, 0x0AD8, 0x0ADE, 0x0AE4, 0x0AEA, 0x0AF1, 
+0x0AF7, 0x0AFD, 0x0B03, 0x0B09, 0x0B10, 0x0B16, 0x0B1C, 0x0B22, 0x0B28, 0x0B2F, 0x0B35, 0x0B3B, 0x0B41, 0x0B47, 0x0B4D, 0x0B54, 
+0x0B5A, 0x0B60, 0x0B66, 0x0B6C, 0x0B72, 0x0B78, 0x0B7F, 0x0B85, 0x0B8B, 0x0B91, 0x0B97, 0x0B9D, 0x0BA3, 0x0BAA, 0x0BB0, 0x0BB6, 
+0x0BBC, 0x0BC2, 0x0BC8, 0x0BCE, 0x0BD4, 0x0BDA, 0x0BE1, 0x0BE7, 0x0BED, 0x0BF3, 0x0BF9, 0x0BFF, 0x0C05, 0x0C0B, 0x0C12, 0x0C18, 
+0x0C1E, 0x0C24, 0x0C2A, 0x0C30, 0x0C36, 0x0C3D, 0x0C43, 0x0C49, 0x0C4F, 0x0C55, 0x0C5B, 0x0C61, 0x0C68, 0x0C6E, 0x0C74, 0x0C7A, 
+0x0C80, 0x0C86, 0x0C8D, 0x0C93, 0x0C99, 0x0C9F, 0x0CA5, 0x0CAB, 0x0CB2, 0x0CB8, 0x0CBE, 0x0CC4, 0x0CCB, 0x0CD1, 0x0CD7, 0x0CDD, 
+0x0CE4, 0x0CEA, 0x0CF0, 0x0CF6, 0x0CFD, 0x0D03, 0x0D09, 0x0D0F, 0x0D16, 0x0D1C, 0x0D22, 0x0D29, 0x0D2F, 0x0D35, 0x0D3C, 0x0D42, 
+0x0D48, 0x0D4F, 0x0D55, 0x0D5B, 0x0D62, 0x0D68, 0x0D6E, 0x0D75, 0x0D7B, 0x0D81, 0x0D88, 0x0D8E, 0x0D94, 0x0D9B, 0x0DA1, 0x0DA7, 
+0x0DAE, 0x0DB4, 0x0DBB, 0x0DC1, 0x0DC7, 0x0DCE, 0x0DD4, 0x0DDA, 0x0DE1, 0x0DE7, 0x0DEE, 0x0DF4, 0x0DFA, 0x0E01, 0x0E07, 0x0E0E, 
+0x0E14, 0x0E1A, 0x0E21, 0x0E27, 0x0E2D, 0x0E34, 0x0E3A, 0x0E41, 0x0E47, 0x0E4D, 0x0E54, 0x0E5A, 0x0E60, 0x0E67, 0x0E6D, 0x0E73, 
+0x0E7A, 0x0E80, 0x0E86, 0x0E8D, 0x0E93, 0x0E99, 0x0EA0, 0x0EA6, 0x0EAC, 0x0EB3, 0x0EB9, 0x0EBF, 0x0EC6, 0x0ECC, 0x0ED2, 0x0ED9, 
+0x0EDF, 0x0EE5, 0x0EEB, 0x0EF2, 0x0EF8, 0x0EFE, 0x0F04, 0x0F0B, 0x0F11, 0x0F17, 0x0F1D, 0x0F24, 0x0F2A, 0x0F30, 0x0F36, 0x0F3C, 
+0x0F43, 0x0F49, 0x0F4F, 0x0F55, 0x0F5B, 0x0F61, 0x0F67, 0x0F6E, 0x0F74, 0x0F7A, 0x0F80, 0x0F86, 0x0F8C, 0x0F92, 0x0F98, 0x0F9E, 
+0x0FA4, 0x0FAA, 0x0FB0, 0x0FB6, 0x0FBC, 0x0FC2, 0x0FC8, 0x0FCE, 0x0FD4, 0x0FDA, 0x0FE0, 0x0FE6, 0x0FEC, 0x0FF2, 0x0FF8, 0x0FFE, 
+0x1004, 0x1009, 0x100F, 0x1015, 0x101B, 0x1021, 0x1026, 0x102C, 0x1032, 0x1038, 0x103D, 0x1043, 0x1049, 0x104E, 0x1054, 0x1059, 
+0x105F, 0x1065, 0x106A, 0x1070, 0x1075, 0x107B, 0x1080, 0x1086, 0x108C, 0x1091, 0x1096, 0x109C, 0x10A1, 0x10A7, 0x10AC, 0x10B2, 
+0x10B7, 0x10BD, 0x10C2, 0x10C7, 0x10CD, 0x10D2, 0x10D8, 0x10DD, 0x10E2, 0x10E8, 0x10ED, 0x10F2, 0x10F8, 0x10FD, 0x1102, 0x1108, 
+0x110D, 0x1112, 0x1118, 0x111D, 0x1122, 0x1127, 0x112D, 0x1132, 0x1137, 0x113D, 0x1142, 0x1147, 0x114C, 0x1152, 0x1157, 0x115C, 
+0x1162, 0x1167, 0x116C, 0x1171, 0x1177, 0x117C, 0x1181, 0x1186, 0x118C, 0x1191, 0x1196, 0x119C, 0x11A1, 0x11A6, 0x11AB, 0x11B1, 
+0x11B6, 0x11BB, 0x11C1, 0x11C6, 0x11CB, 0x11D1, 0x11D6, 0x11DB, 0x11E1, 0x11E6, 0x11EB, 0x11F1, 0x11F6, 0x11FC, 0x1201, 0x1206, 
+0x120C, 0x1211, 0x1217, 0x121C, 0x1222, 0x1227, 0x122D, 0x1232, 0x1237, 0x123D, 0x1243, 0x1248, 0x124E, 0x1253, 0x1259, 0x125E, 
+0x1264, 0x126A, 0x126F, 0x1275, 0x127A, 0x1280, 0x1286, 0x128B, 0x1291, 0x1297, 0x129D, 0x12A2, 0x12A8, 0x12AE, 0x12B4, 0x12BA, 
+0x12C0, 0x12C5, 0x12CB, 0x12D1, 0x12D7, 0x12DD, 0x12E3, 0x12E9, 0x12EF, 0x12F4, 0x12FA, 0x1300, 0x1306, 0x130C, 0x1312, 0x1318, 
+0x131E, 0x1324, 0x132A, 0x1330, 0x1336, 0x133C, 0x1342, 0x1348, 0x134E, 0x1354, 0x135A, 0x1360, 0x1366, 0x136C, 0x1372, 0x1378, 
+0x137E, 0x1384, 0x138A, 0x1390, 0x1396, 0x139C, 0x13A3, 0x13A9, 0x13AF, 0x13B5, 0x13BB, 0x13C1, 0x13C7, 0x13CD, 0x13D3, 0x13DA, 
+0x13E0, 0x13E6, 0x13EC, 0x13F2, 0x13F8, 0x13FF, 0x1405, 0x140B, 0x1411, 0x1417, 0x141E, 0x1424, 0x142A, 0x1430, 0x1437, 0x143D, 
+0x1443, 0x1449, 0x1450, 0x1456, 0x145C, 0x1462, 0x1469, 0x146F, 0x1475, 0x147B, 0x1482, 0x1488, 0x148E, 0x1495, 0x149B, 0x14A1, 
+0x14A8, 0x14AE, 0x14B4, 0x14BB, 0x14C1, 0x14C8, 0x14CE, 0x14D4, 0x14DB, 0x14E1, 0x14E8, 0x14EE, 0x14F4, 0x14FB, 0x1501, 0x1508, 
+0x150E, 0x1515, 0x151B, 0x1521, 0x1528, 0x152E, 0x1535, 0x153B, 0x1542, 0x1548, 0x154F, 0x1555, 0x155C, 0x1562, 0x1569, 0x156F, 
+0x1576, 0x157D, 0x1583, 0x158A, 0x1590, 0x1597, 0x159D, 0x15A4, 0x15AB, 0x15B1, 0x15B8, 0x15BE, 0x15C5, 0x15CC, 0x15D2, 0x15D9, 
+0x15E0, 0x15E6, 0x15ED, 0x15F3, 0x15FA, 0x1601, 0x1607, 0x160E, 0x1615, 0x161C, 0x1622, 0x1629, 0x1630, 0x1636, 0x163D, 0x1644, 
+0x164B, 0x1651, 0x1658, 0x165F, 0x1666, 0x166C, 0x1673, 0x167A, 0x1681, 0x1687, 0x168E, 0x1695, 0x169C, 0x16A3, 0x16A9, 0x16B0, 
+0x16B7, 0x16BE, 0x16C5, 0x16CC, 0x16D3, 0x16D9, 0x16E0, 0x16E7, 0x16EE, 0x16F5, 0x16FC, 0x1703, 0x170A, 0x1711, 0x1717, 0x171E, 
+0x1725, 0x172C, 0x1733, 0x173A, 0x1741, 0x1748, 0x174F, 0x1756, 0x175D, 0x1764, 0x176B, 0x1772, 0x1779, 0x1780, 0x1787, 0x178E, 
+0x1795, 0x179C, 0x17A3, 0x17AA, 0x17B1, 0x17B8, 0x17BF, 0x17C6, 0x17CD, 0x17D5, 0x17DC, 0x17E3, 0x17EA, 0x17F1, 0x17F8, 0x17FF, 
+0x1806, 0x180D, 0x1815, 0x181C, 0x1823, 0x182A, 0x1831, 0x1838, 0x1840, 0x1847, 0x184E, 0x1855, 0x185C, 0x1863, 0x186B, 0x1872, 
+0x1879, 0x1880, 0x1888, 0x188F, 0x1896, 0x189D, 0x18A5, 0x18AC, 0x18B3, 0x18BA, 0x18C2, 0x18C9, 0x18D0, 0x18D8, 0x18DF, 0x18E6, 
+0x18EE, 0x18F5, 0x18FC, 0x1904, 0x190B, 0x1912, 0x191A, 0x1921, 0x1928, 0x1930, 0x1937, 0x193E, 0x1946, 0x194D, 0x1955, 0x195C, 
+0x1964, 0x196B, 0x1972, 0x197A, 0x1981, 0x1989, 0x1990, 0x1998, 0x199F, 0x19A7, 0x19AF, 0x19B6, 0x19BE, 0x19C5, 0x19CD, 0x19D5, 
+0x19DC, 0x19E4, 0x19EC, 0x19F3, 0x19FB, 0x1A03, 0x1A0B, 0x1A12, 0x1A1A, 0x1A22, 0x1A2A, 0x1A32, 0x1A39, 0x1A41, 0x1A49, 0x1A51, 
+0x1A59, 0x1A61, 0x1A69, 0x1A70, 0x1A78, 0x1A80, 0x1A88, 0x1A90, 0x1A98, 0x1AA0, 0x1AA8, 0x1AB0, 0x1AB8, 0x1AC0, 0x1AC8, 0x1AD0, 
+0x1AD8, 0x1AE0, 0x1AE8, 0x1AF0, 0x1AF7, 0x1AFF, 0x1B07, 0x1B0F, 0x1B17, 0x1B1F, 0x1B27, 0x1B2F, 0x1B37, 0x1B3F, 0x1B47, 0x1B4F, 
+0x1B58, 0x1B60, 0x1B68, 0x1B70, 0x1B78, 0x1B80, 0x1B88, 0x1B90, 0x1B98, 0x1BA0, 0x1BA8, 0x1BB0, 0x1BB8, 0x1BBF, 0x1BC7, 0x1BCF, 
+0x1BD7, 0x1BDF, 0x1BE7, 0x1BEF, 0x1BF7, 0x1BFF, 0x1C07, 0x1C0F, 0x1C17, 0x1C1F, 0x1C27, 0x1C2F, 0x1C37, 0x1C3F, 0x1C46, 0x1C4E, 
+0x1C56, 0x1C5E, 0x1C66, 0x1C6E, 0x1C76, 0x1C7D, 0x1C85, 0x1C8D, 0x1C95, 0x1C9D, 0x1CA4, 0x1CAC, 0x1CB4, 0x1CBC, 0x1CC3, 0x1CCB, 
+0x1CD3, 0x1CDA, 0x1CE2, 0x1CEA, 0x1CF1, 0x1CF9, 0x1D00, 0x1D08, 0x1D10, 0x1D17, 0x1D1F, 0x1D26, 0x1D2E, 0x1D35, 0x1D3D, 0x1D44, 
+0x1D4C, 0x1D53, 0x1D5A, 0x1D62, 0x1D69, 0x1D71, 0x1D78, 0x1D7F, 0x1D87, 0x1D8E, 0x1D95, 0x1D9D, 0x1DA4, 0x1DAB, 0x1DB3, 0x1DBA, 
+0x1DC1, 0x1DC9, 0x1DD0, 0x1DD7, 0x1DDF, 0x1DE6, 0x1DED, 0x1DF5, 0x1DFC, 0x1E03, 0x1E0A, 0x1E12, 0x1E19, 0x1E20, 0x1E27, 0x1E2F, 
+0x1E36, 0x1E3D, 0x1E44, 0x1E4C, 0x1E53, 0x1E5A, 0x1E61, 0x1E68, 0x1E6F, 0x1E77, 0x1E7E, 0x1E85, 0x1E8C, 0x1E93, 0x1E9A, 0x1EA2, 
+0x1EA9, 0x1EB0, 0x1EB7, 0x1EBE, 0x1EC5, 0x1ECC, 0x1ED3, 0x1EDA, 0x1EE2, 0x1EE9, 0x1EF0, 0x1EF7, 0x1EFE, 0x1F05, 0x1F0C, 0x1F13, 
+0x1F1A, 0x1F21, 0x1F28, 0x1F2F, 0x1F36, 0x1F3D, 0x1F44, 0x1F4B, 0x1F52, 0x1F59, 0x1F60, 0x1F67, 0x1F6E, 0x1F75, 0x1F7C, 0x1F83, 
+0x1F8A, 0x1F91, 0x1F98, 0x1F9E, 0x1FA5, 0x1FAC, 0x1FB3, 0x1FBA, 0x1FC1, 0x1FC8, 0x1FCF, 0x1FD6, 0x1FDC, 0x1FE3, 0x1FEA, 0x1FF1, 
+0x1FF8, 0x1FFF, 0x2006, 0x200C, 0x2013, 0x201A, 0x2021, 0x2028, 0x202E, 0x2035, 0x203C, 0x2043, 0x2049, 0x2050, 0x2057, 0x205E, 
+0x2064, 0x206B, 0x2072, 0x2079, 0x207F, 0x2086, 0x208D, 0x2093, 0x209A, 0x20A1, 0x20A8, 0x20AE, 0x20B5, 0x20BC, 0x20C2, 0x20C9, 
+0x20D0, 0x20D6, 0x20DD, 0x20E3, 0x20EA, 0x20F1, 0x20F7, 0x20FE, 0x2105, 0x210B, 0x2112, 0x2119, 0x211F, 0x2126, 0x212C, 0x2133, 
+0x213A, 0x2140, 0x2147, 0x214E, 0x2154, 0x215B, 0x2161, 0x2168, 0x216F, 0x2175, 0x217C, 0x2182, 0x2189, 0x218F, 0x2196, 0x219D, 
+0x21A3, 0x21AA, 0x21B0, 0x21B7, 0x21BD, 0x21C4, 0x21CB, 0x21D1, 0x21D8, 0x21DE, 0x21E5, 0x21EB, 0x21F2, 0x21F8, 0x21FF, 0x2205, 
+0x220C, 0x2212, 0x2219, 0x221F, 0x2225, 0x222C, 0x2232, 0x2239, 0x223F, 0x2246, 0x224C, 0x2252, 0x2259, 0x225F, 0x2266, 0x226C, 
+0x2272, 0x2279, 0x227F, 0x2285, 0x228C, 0x2292, 0x2298, 0x229E, 0x22A5, 0x22AB, 0x22B1, 0x22B7, 0x22BE, 0x22C4, 0x22CA, 0x22D0, 
+0x22D7, 0x22DD, 0x22E3, 0x22E9, 0x22EF, 0x22F5, 0x22FB, 0x2302, 0x2308, 0x230E, 0x2314, 0x231A, 0x2320, 0x2326, 0x232C, 0x2332, 
+0x2338, 0x233E, 0x2344, 0x234A, 0x2350, 0x2356, 0x235C, 0x2361, 0x2367, 0x236D, 0x2373, 0x2379, 0x237F, 0x2384, 0x238A, 0x2390, 
+0x2396, 0x239B, 0x23A1, 0x23A7, 0x23AD, 0x23B2, 0x23B8, 0x23BE, 0x23C3, 0x23C9, 0x23CE, 0x23D4, 0x23D9, 0x23DF, 0x23E5, 0x23EA, 
+0x23F0, 0x23F5, 0x23FA, 0x2400, 0x2405, 0x240A, 0x2410, 0x2415, 0x241A, 0x2420, 0x2425, 0x242A, 0x242F, 0x2434, 0x2439, 0x243E, 
+0x2443, 0x2448, 0x244D, 0x2452, 0x2457, 0x245C, 0x2461, 0x2466, 0x246B, 0x2470, 0x2475, 0x2479, 0x247E, 0x2483, 0x2488, 0x248C, 
+0x2491, 0x2496, 0x249B, 0x249F, 0x24A4, 0x24A9, 0x24AD, 0x24B2, 0x24B6, 0x24BB, 0x24C0, 0x24C4, 0x24C9, 0x24CD, 0x24D2, 0x24D6, 
+0x24DB, 0x24DF, 0x24E4, 0x24E8, 0x24ED, 0x24F1, 0x24F6, 0x24FA, 0x24FE, 0x2503, 0x2507, 0x250C, 0x2510, 0x2515, 0x2519, 0x251D, 
+0x2522, 0x2526, 0x252B, 0x252F, 0x2533, 0x2538, 0x253C, 0x2540, 0x2545, 0x2549, 0x254E, 0x2552, 0x2556, 0x255B, 0x255F, 0x2564, 
+0x2568, 0x256C, 0x2571, 0x2575, 0x257A, 0x257E, 0x2582, 0x2587, 0x258B, 0x2590, 0x2594, 0x2599, 0x259D, 0x25A2, 0x25A6, 0x25AB, 
+0x25AF, 0x25B4, 0x25B8, 0x25BD, 0x25C1, 0x25C6, 0x25CA, 0x25CF, 0x25D4, 0x25D8, 0x25DD, 0x25E2, 0x25E6, 0x25EB, 0x25F0, 0x25F4, 
+0x25F9, 0x25FE, 0x2603, 0x2607, 0x260C, 0x2611, 0x2616, 0x261B, 0x2620, 0x2625, 0x2629, 0x262E, 0x2633, 0x2638, 0x263D, 0x2642, 
+0x2648, 0x264D, 0x2652, 0x2657, 0x265C, 0x2661, 0x2666, 0x266C, 0x2671, 0x2676, 0x267B, 0x2681, 0x2686, 0x268B, 0x2691, 0x2696, 
+0x269C, 0x26A1, 0x26A6, 0x26AC, 0x26B1, 0x26B7, 0x26BC, 0x26C2, 0x26C7, 0x26CD, 0x26D3, 0x26D8, 0x26DE, 0x26E3, 0x26E9, 0x26EF, 
+0x26F4, 0x26FA, 0x26FF, 0x2705, 0x270B, 0x2710, 0x2716, 0x271C, 0x2722, 0x2727, 0x272D, 0x2733, 0x2738, 0x273E, 0x2744, 0x274A, 
+0x274F, 0x2755, 0x275B, 0x2761, 0x2767, 0x276C, 0x2772, 0x2778, 0x277E, 0x2783, 0x2789, 0x278F, 0x2795, 0x279A, 0x27A0, 0x27A6, 
+0x27AC, 0x27B2, 0x27B7, 0x27BD, 0x27C3, 0x27C9, 0x27CE, 0x27D4, 0x27DA, 0x27DF, 0x27E5, 0x27EB, 0x27F1, 0x27F6, 0x27FC, 0x2802, 
+0x2807, 0x280D, 0x2813, 0x2818, 0x281E, 0x2823, 0x2829, 0x282F, 0x2834, 0x283A, 0x283F, 0x2845, 0x284A, 0x2850, 0x2855, 0x285B, 
+0x2860, 0x2866, 0x286B, 0x2870, 0x2876, 0x287B, 0x2881, 0x2886, 0x288B, 0x2890, 0x2896, 0x289B, 0x28A0, 0x28A5, 0x28AB, 0x28B0, 
+0x28B5, 0x28BA, 0x28BF, 0x28C4, 0x28C9, 0x28CE, 0x28D3, 0x28D8, 0x28DD, 0x28E2, 0x28E7, 0x28EC, 0x28F1, 0x28F5, 0x28FA, 0x28FF, 
+0x2904, 0x2908, 0x290D, 0x2911, 0x2916, 0x291A, 0x291F, 0x2923, 0x2928, 0x292C, 0x2931, 0x2935, 0x2939, 0x293E, 0x2942, 0x2946, 
+0x294A, 0x294E, 0x2952, 0x2957, 0x295B, 0x295F, 0x2963, 0x2967, 0x296B, 0x296F, 0x2973, 0x2977, 0x297A, 0x297E, 0x2982, 0x2986, 
+0x298A, 0x298E, 0x2991, 0x2995, 0x2999, 0x299D, 0x29A0, 0x29A4, 0x29A8, 0x29AB, 0x29AF, 0x29B3, 0x29B6, 0x29BA, 0x29BE, 0x29C1, 
+0x29C5, 0x29C8, 0x29CC, 0x29D0, 0x29D3, 0x29D7, 0x29DA, 0x29DE, 0x29E1, 0x29E5, 0x29E8, 0x29EC, 0x29EF, 0x29F3, 0x29F6, 0x29FA, 
+0x29FE, 0x2A01, 0x2A05, 0x2A08, 0x2A0C, 0x2A0F, 0x2A13, 0x2A16, 0x2A1A, 0x2A1D, 0x2A21, 0x2A24, 0x2A28, 0x2A2B, 0x2A2F, 0x2A33, 
+0x2A36, 0x2A3A, 0x2A3D, 0x2A41, 0x2A45, 0x2A48, 0x2A4C, 0x2A50, 0x2A53, 0x2A57, 0x2A5B, 0x2A5E, 0x2A62, 0x2A66, 0x2A6A, 0x2A6D, 
+0x2A71, 0x2A75, 0x2A79, 0x2A7D, 0x2A81, 0x2A84, 0x2A88, 0x2A8C, 0x2A90, 0x2A94, 0x2A98, 0x2A9C, 0x2AA0, 0x2AA4, 0x2AA9, 0x2AAD, 
+0x2AB1, 0x2AB5, 0x2AB9, 0x2ABD, 0x2AC2, 0x2AC6, 0x2ACA, 0x2ACF, 0x2AD3, 0x2AD8, 0x2ADC, 0x2AE1, 0x2AE5, 0x2AEA, 0x2AEE, 0x2AF3, 
+0x2AF8, 0x2AFC, 0x2B01, 0x2B06, 0x2B0A, 0x2B0F, 0x2B14, 0x2B19, 0x2B1E, 0x2B22, 0x2B27, 0x2B2C, 0x2B31, 0x2B36, 0x2B3B, 0x2B40, 
+0x2B45, 0x2B4A, 0x2B4F, 0x2B54, 0x2B59, 0x2B5E, 0x2B63, 0x2B68, 0x2B6D, 0x2B72, 0x2B77, 0x2B7C, 0x2B81, 0x2B86, 0x2B8C, 0x2B91, 
+0x2B96, 0x2B9B, 0x2BA0, 0x2BA6, 0x2BAB, 0x2BB0, 0x2BB5, 0x2BBB, 0x2BC0, 0x2BC5, 0x2BCB, 0x2BD0, 0x2BD5, 0x2BDB, 0x2BE0, 0x2BE5, 
+0x2BEB, 0x2BF0, 0x2BF6, 0x2BFB, 0x2C00, 0x2C06, 0x2C0B, 0x2C11, 0x2C16, 0x2C1C, 0x2C21, 0x2C27, 0x2C2C, 0x2C32, 0x2C37, 0x2C3D, 
+0x2C42, 0x2C48, 0x2C4E, 0x2C53, 0x2C59, 0x2C5E, 0x2C64, 0x2C6A, 0x2C6F, 0x2C75, 0x2C7A, 0x2C80, 0x2C86, 0x2C8B, 0x2C91, 0x2C97, 
+0x2C9C, 0x2CA2, 0x2CA8, 0x2CAE, 0x2CB3, 0x2CB9, 0x2CBF, 0x2CC4, 0x2CCA, 0x2CD0, 0x2CD6, 0x2CDB, 0x2CE1, 0x2CE7, 0x2CED, 0x2CF3, 
+0x2CF8, 0x2CFE, 0x2D04, 0x2D0A, 0x2D10, 0x2D15, 0x2D1B, 0x2D21, 0x2D27, 0x2D2D, 0x2D33, 0x2D38, 0x2D3E, 0x2D44, 0x2D4A, 0x2D50, 
+0x2D56, 0x2D5B, 0x2D61, 0x2D67, 0x2D6D, 0x2D73, 0x2D79, 0x2D7F, 0x2D84, 0x2D8A, 0x2D90, 0x2D96, 0x2D9C, 0x2DA2, 0x2DA8, 0x2DAE, 
+0x2DB4, 0x2DB9, 0x2DBF, 0x2DC5, 0x2DCB, 0x2DD1, 0x2DD7, 0x2DDD, 0x2DE3, 0x2DE9, 0x2DEF, 0x2DF5, 0x2DFB, 0x2E01, 0x2E07, 0x2E0D, 
+0x2E13, 0x2E19, 0x2E1F, 0x2E25, 0x2E2B, 0x2E31, 0x2E37, 0x2E3D, 0x2E43, 0x2E49, 0x2E50, 0x2E56, 0x2E5C, 0x2E62, 0x2E68, 0x2E6E, 
+0x2E74, 0x2E7B, 0x2E81, 0x2E87, 0x2E8D, 0x2E93, 0x2E99, 0x2EA0, 0x2EA6, 0x2EAC, 0x2EB2, 0x2EB9, 0x2EBF, 0x2EC5, 0x2ECB, 0x2ED2, 
+0x2ED8, 0x2EDE, 0x2EE4, 0x2EEB, 0x2EF1, 0x2EF7, 0x2EFD, 0x2F04, 0x2F0A, 0x2F10, 0x2F17, 0x2F1D, 0x2F23, 0x2F2A, 0x2F30, 0x2F36, 
+0x2F3D, 0x2F43, 0x2F49, 0x2F50, 0x2F56, 0x2F5D, 0x2F63, 0x2F69, 0x2F70, 0x2F76, 0x2F7D, 0x2F83, 0x2F89, 0x2F90, 0x2F96, 0x2F9D, 
+0x2FA3, 0x2FA9, 0x2FB0, 0x2FB6, 0x2FBD, 0x2FC3, 0x2FCA, 0x2FD0, 0x2FD6, 0x2FDD, 0x2FE3, 0x2FEA, 0x2FF0, 0x2FF7, 0x2FFD, 0x3004, 
+0x300A, 0x3011, 0x3017, 0x301E, 0x3024, 0x302B, 0x3031, 0x3037, 0x303E, 0x3044, 0x304B, 0x3051, 0x3058, 0x305E, 0x3065, 0x306B, 
+0x3072, 0x3078, 0x307F, 0x3085, 0x308C, 0x3092, 0x3099, 0x309F, 0x30A6, 0x30AC, 0x30B3, 0x30B9, 0x30C0, 0x30C6, 0x30CD, 0x30D3, 
+};
@@ -0,0 +1,22 @@
+// Band-limited decimation filter for the SAMPLE_RESAMPLE_* sampling methods.
+// Kaiser windowed sinc, 500 taps at 4 times the output sample rate, cutoff at
+// 0.475*fs, designed for 96dB stopband attenuation (about 75dB after quantizing
+// the coefficients to 2^15). The 32 taps at each end quantize to zero and are
+// left out, which leaves 436 taps.
+// The filter is symmetric, only the first half of the taps is stored.
+const short fir_table[] = {
+     0,     -1,      0,      0,      1,      1,      0,      0,     -1,     -1,     -1,      0,      1,      1,      1,      0, 
+    -1,     -1,     -1,     -1,      0,      1,      2,      1,      0,     -2,     -2,     -2,      0,      2,      3,      2, 
+     0,     -2,     -3,     -3,     -1,      1,      3,      4,      2,     -1,     -4,     -4,     -3,      0,      4,      5, 
+     4,      0,     -4,     -6,     -5,     -1,      4,      7,      7,      3,     -3,     -8,     -8,     -5,      2,      8, 
+    10,      7,     -1,     -8,    -11,     -9,     -1,      8,     13,     11,      4,     -7,    -14,    -14,     -6,      5, 
+    15,     17,     10,     -3,    -15,    -20,    -13,      0,     15,     22,     18,      3,    -14,    -24,    -22,     -8, 
+    12,     26,     27,     13,     -9,    -27,    -31,    -19,      5,     27,     36,     25,      1,    -26,    -40,    -33, 
+    -7,     23,     43,     40,     15,    -19,    -45,    -48,    -24,     13,     46,     55,     35,     -6,    -45,    -62, 
+   -46,     -4,     42,     68,     58,     15,    -37,    -72,    -70,    -29,     30,     75,     82,     44,    -19,    -76, 
+   -94,    -62,      6,     74,    105,     80,     11,    -68,   -114,   -100,    -31,     59,    121,    120,     54,    -45, 
+  -125,   -141,    -81,     27,    126,    161,    111,     -3,   -122,   -180,   -144,    -26,    112,    198,    180,     62, 
+   -97,   -212,   -219,   -106,     73,    223,    262,    158,    -39,   -229,   -307,   -221,     -7,    229,    357,    298, 
+    69,   -220,   -412,   -394,   -154,    198,    477,    519,    275,   -156,   -557,   -697,   -460,     81,    671,    985, 
+   786,     72,   -879,  -1585,  -1552,   -496,   1506,   3991,   6255,   7603, 
+};
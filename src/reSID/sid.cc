@@ -23,40 +23,53 @@
 RESID_NAMESPACE_START
 
 // Resampling constants.
-// The error in interpolated lookup is bounded by 1.234/L^2,
-// while the error in non-interpolated lookup is bounded by
-// 0.7854/L + 0.4113/L^2, see
-// http://www-ccrma.stanford.edu/~jos/resample/Choice_Table_Size.html
-// For a resolution of 16 bits this yields L >= 285 and L >= 51473,
-// respectively.
-const int SID::FIR_N = 125;
-const int SID::FIR_RES_INTERPOLATE = 285;
-const int SID::FIR_RES_FAST = 51473;
-const int SID::FIR_SHIFT = 15;
-const int SID::RINGSIZE = 16384;
+// The chip output is sampled at FIR_RES times the output sample frequency
+// and decimated by the band-limited FIR filter in firtable.h. The filter
+// has FIR_N*FIR_RES taps, i.e. the impulse response spans FIR_N output
+// samples. Using a fixed oversampling ratio makes the filter independent of
+// the clock and sample frequencies, so it can be kept in flash, and the ring
+// buffer only has to hold one impulse response.
+template<chip_model model>
+const int SIDChip<model>::FIR_N = 109;
+template<chip_model model>
+const int SIDChip<model>::FIR_RES = 4;
+template<chip_model model>
+const int SIDChip<model>::FIR_SHIFT = 15;
 
 // Fixpoint constants (16.16 bits).
-const int SID::FIXP_SHIFT = 16;
-const int SID::FIXP_MASK = 0xffff;
+template<chip_model model>
+const int SIDChip<model>::FIXP_SHIFT = 16;
+template<chip_model model>
+const int SIDChip<model>::FIXP_MASK = 0xffff;
 
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
-SID::SID()
+template<chip_model model>
+SIDChip<model>::SIDChip()
 {
 
   voice[0].set_sync_source(&voice[2]);
   voice[1].set_sync_source(&voice[0]);
   voice[2].set_sync_source(&voice[1]);
 
+  idle = false;
+  idle_delta_t = 0;
+  idle_cycles = 0;
+  idle_samples = 0;
+  idle_sample = 0;
+
   // set_sampling_parameters(985248, SAMPLE_FAST, AUDIO_SAMPLE_RATE_EXACT);  
   set_sampling_parameters(985248, SAMPLE_FAST, 22050);  
 
   bus_value = 0;
   bus_value_ttl = 0;
+  memset(shadow_register, 0, sizeof(shadow_register));
 
   ext_in = 0;
 
+  voice_pan[0] = voice_pan[1] = voice_pan[2] = 0;
+  capture = 0;
 }
 /*
 void SID::printFilter(void){
@@ -70,30 +83,17 @@ void SID::printFilter(void){
 // ----------------------------------------------------------------------------
 // Destructor.
 // ----------------------------------------------------------------------------
-SID::~SID()
+template<chip_model model>
+SIDChip<model>::~SIDChip()
 {
 }
 
 
-// ----------------------------------------------------------------------------
-// Set chip model.
-// ----------------------------------------------------------------------------
-/*
-void SID::set_chip_model(chip_model model)
-{
-  voice[0].set_chip_model(model);
-  voice[1].set_chip_model(model);
-  voice[2].set_chip_model(model);
-
-  filter.set_chip_model(model);
-  extfilt.set_chip_model(model);
-}
-*/
-
 // ----------------------------------------------------------------------------
 // SID reset.
 // ----------------------------------------------------------------------------
-void SID::reset()
+template<chip_model model>
+void SIDChip<model>::reset()
 {
 
 	voice[0].reset();
@@ -102,9 +102,14 @@ void SID::reset()
 	
   filter.reset();
   extfilt.reset();
+  side_extfilt.reset();
 
   bus_value = 0;
   bus_value_ttl = 0;
+  memset(shadow_register, 0, sizeof(shadow_register));
+
+  idle = false;
+  idle_cycles = 0;
 }
 
 
@@ -114,8 +119,11 @@ void SID::reset()
 // Note that to mix in an external audio signal, the signal should be
 // resampled to 1MHz first to avoid sampling noise.
 // ----------------------------------------------------------------------------
-void SID::input(int sample)
+template<chip_model model>
+void SIDChip<model>::input(int sample)
 {
+  wake();
+
   // Voice outputs are 20 bits. Scale up to match three voices in order
   // to facilitate simulation of the MOS8580 "digi boost" hardware hack.
   ext_in = (sample << 4)*3;
@@ -125,7 +133,8 @@ void SID::input(int sample)
 // Read sample from audio output.
 // Both 16-bit and n-bit output is provided.
 // ----------------------------------------------------------------------------
-int SID::output()
+template<chip_model model>
+int SIDChip<model>::output()
 {
   const int range = 1 << 16;
   const int half = range >> 1;
@@ -139,7 +148,8 @@ int SID::output()
   return sample;
 }
 
-int SID::output(int bits)
+template<chip_model model>
+int SIDChip<model>::output(int bits)
 {
   const int range = 1 << bits;
   const int half = range >> 1;
@@ -154,6 +164,93 @@ int SID::output(int bits)
 }
 
 
+// ----------------------------------------------------------------------------
+// Voice output for the side channel and the voice buffers, waveform x
+// envelope around the waveform midpoint, range [-2048*255, 2047*255].
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+int SIDChip<model>::voice_tap(int i)
+{
+  if (voice[i].muted) {
+    return 0;
+  }
+  return (voice[i].wave.output() - 0x800)*voice[i].envelope.output();
+}
+
+
+// ----------------------------------------------------------------------------
+// Side channel sample for the panned voices, scaled like output().
+// Only the voices mixed around the filter are panned, there is a single
+// filter output which has to stay centered. The waveforms are tapped around
+// their midpoint, since the D/A offsets of the MOS6581 only reach the output
+// through the DC blocking external filter.
+// The side channel is only tapped at the sample points, delta_t cycles
+// apart. It goes through an external filter of its own, held at the tapped
+// value in between, so its high-pass and low-pass follow those of output().
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+short SIDChip<model>::side_output(cycle_count delta_t)
+{
+  const int range = 1 << 16;
+  const int half = range >> 1;
+  reg8 filtered = filter.enabled ? filter.filt : 0;
+  if (filter.voice3off) {
+    filtered |= ~filter.filt & 0x04;
+  }
+
+  // A voice panned to the left adds to the left channel, buf + side.
+  int side = 0;
+  for (int i = 0; i < 3; i++) {
+    if (voice_pan[i] && !(filtered & (1 << i))) {
+      side -= voice_pan[i]*(voice_tap(i) >> 7);
+    }
+  }
+
+  // Scaled to the external filter input, see output()
+  side = (side >> 15)*static_cast<int>(filter.vol);
+  if (extfilt.enabled) {
+    side_extfilt.clock(delta_t, side);
+    side = side_extfilt.output();
+  }
+  side /= (4095*255 >> 7)*3*15*2/range;
+  if (side >= half) {
+    return half - 1;
+  }
+  if (side < -half) {
+    return -half;
+  }
+  return side;
+}
+
+
+// ----------------------------------------------------------------------------
+// Store the voice outputs of every decimation'th sample, scaled to 16 bits.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+void SIDChip<model>::capture_voices()
+{
+  VoiceCapture& c = *capture;
+
+  if (++c.phase < c.decimation) {
+    return;
+  }
+  c.phase = 0;
+  if (c.length >= c.size) {
+    return;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    if (c.buf[i]) {
+      c.buf[i][c.length] = voice_tap(i) >> 4;
+    }
+  }
+  c.length++;
+}
+
+
 // ----------------------------------------------------------------------------
 // Read registers.
 //
@@ -171,8 +268,11 @@ int SID::output(int bits)
 // value instead). With this in mind we return the last value written to
 // any SID register for $2000 cycles without modeling the bit fading.
 // ----------------------------------------------------------------------------
-reg8 SID::read(reg8 offset)
+template<chip_model model>
+reg8 SIDChip<model>::read(reg8 offset)
 {
+  catch_up();
+
   switch (offset) {
   case 0x19:
     return potx.readPOT();
@@ -191,11 +291,18 @@ reg8 SID::read(reg8 offset)
 // ----------------------------------------------------------------------------
 // Write registers.
 // ----------------------------------------------------------------------------
-void SID::write(reg8 offset, reg8 value)
+template<chip_model model>
+void SIDChip<model>::write(reg8 offset, reg8 value)
 {
+  wake();
+
   bus_value = value;
   bus_value_ttl = 0x2000;
 
+  if (offset < 0x19) {
+    shadow_register[offset] = value;
+  }
+
   switch (offset) {
   case 0x00:
     voice[0].wave.writeFREQ_LO(value);
@@ -278,17 +385,70 @@ void SID::write(reg8 offset, reg8 value)
 }
 
 
+// ----------------------------------------------------------------------------
+// Write a register dump.
+// Rewriting a register with its current value has no effect on the chip, so
+// only the changed registers are dispatched. They are written in ascending
+// order, as by a full register sweep, so a changed frequency or pulse width
+// of a voice is in place before a gate or test bit edge in its control
+// register, and the chip ends up in the same state as after the full sweep.
+// An unchanged dump leaves an idle chip idle.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+void SIDChip<model>::write_block(const uint8_t* regs)
+{
+  for (int i = 0; i < 0x19; i++) {
+    if (regs[i] != shadow_register[i]) {
+      write(i, regs[i]);
+    }
+  }
+
+  // The bus holds the last value of the sweep, as after 25 writes.
+  if (idle) {
+    catch_up();
+  }
+  bus_value = regs[0x18];
+  bus_value_ttl = 0x2000;
+}
+
+
 // ----------------------------------------------------------------------------
 // SID voice muting.
 // ----------------------------------------------------------------------------
-void SID::mute(reg8 channel, bool enable)
+template<chip_model model>
+void SIDChip<model>::mute(reg8 channel, bool enable)
 {
   // Only have 3 voices!
   if (channel >= 3)
     return;
 
+  wake();
   voice[channel].mute (enable);
 }
+
+
+// ----------------------------------------------------------------------------
+// Stereo placement of a voice.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+void SIDChip<model>::set_voice_pan(int i, int pan)
+{
+  if (i < 0 || i >= 3)
+    return;
+
+  if (pan < -32768) {
+    pan = -32768;
+  }
+  else if (pan > 32767) {
+    pan = 32767;
+  }
+  // The side channel starts from silence when panning is turned on
+  if (!voice_panned()) {
+    side_extfilt.reset();
+    memset(side_sample, 0, sizeof(side_sample));
+  }
+  voice_pan[i] = pan;
+}
   
 
 // ----------------------------------------------------------------------------
@@ -322,13 +482,16 @@ SID::State::State()
 // ----------------------------------------------------------------------------
 // Read state.
 // ----------------------------------------------------------------------------
-SID::State SID::read_state()
+template<chip_model model>
+SID::State SIDChip<model>::read_state()
 {
   State state;
   int i, j;
 
+  catch_up();
+
   for (i = 0, j = 0; i < 3; i++, j += 7) {
-    WaveformGenerator& wave = voice[i].wave;
+    WaveformGenerator<model>& wave = voice[i].wave;
     EnvelopeGenerator& envelope = voice[i].envelope;
     state.sid_register[j + 0] = wave.freq & 0xff;
     state.sid_register[j + 1] = wave.freq >> 8;
@@ -382,7 +545,8 @@ SID::State SID::read_state()
 // ----------------------------------------------------------------------------
 // Write state.
 // ----------------------------------------------------------------------------
-void SID::write_state(const State& state)
+template<chip_model model>
+void SIDChip<model>::write_state(const State& state)
 {
   int i;
 
@@ -410,8 +574,10 @@ void SID::write_state(const State& state)
 // ----------------------------------------------------------------------------
 // Enable filter.
 // ----------------------------------------------------------------------------
-void SID::enable_filter(bool enable)
+template<chip_model model>
+void SIDChip<model>::enable_filter(bool enable)
 {
+  wake();
   filter.enable_filter(enable);
 }
 
@@ -419,8 +585,10 @@ void SID::enable_filter(bool enable)
 // ----------------------------------------------------------------------------
 // Enable external filter.
 // ----------------------------------------------------------------------------
-void SID::enable_external_filter(bool enable)
+template<chip_model model>
+void SIDChip<model>::enable_external_filter(bool enable)
 {
+  wake();
   extfilt.enable_filter(enable);
 }
 
@@ -459,12 +627,11 @@ float SID::I0(float x)
 // for sample frequencies up to ~ 44.1kHz, and 20kHz for higher sample
 // frequencies.
 //
-// For resampling, the ratio between the clock frequency and the sample
-// frequency is limited as follows:
-//   125*clock_freq/sample_freq < 16384
+// For resampling, the chip is sampled at 4 times the sample frequency,
+// which must not exceed the clock frequency:
+//   4*sample_freq <= clock_freq
 // E.g. provided a clock frequency of ~ 1MHz, the sample frequency can not
-// be set lower than ~ 8kHz. A lower sample frequency would make the
-// resampling code overfill its 16k sample ring buffer.
+// be set higher than ~ 246kHz.
 // 
 // The end of passband frequency is also limited:
 //   pass_freq <= 0.9*sample_freq/2
@@ -473,7 +640,8 @@ float SID::I0(float x)
 // to slightly below 20kHz. This constraint ensures that the FIR table is
 // not overfilled.
 // ----------------------------------------------------------------------------
-bool SID::set_sampling_parameters(float clock_freq, sampling_method method,
+template<chip_model model>
+bool SIDChip<model>::set_sampling_parameters(float clock_freq, sampling_method method,
 				  float sample_freq, float pass_freq,
 				  float filter_scale)
 {
@@ -497,17 +665,43 @@ bool SID::set_sampling_parameters(float clock_freq, sampling_method method,
     return false;
   }
 
+  // Check whether the oversampled frequency exceeds the clock frequency.
+  if ((method == SAMPLE_RESAMPLE_INTERPOLATE || method == SAMPLE_RESAMPLE_FAST)
+      && sample_freq*FIR_RES > clock_freq) {
+    return false;
+  }
+
+  // The idle state depends on the step lengths of the sampling method.
+  wake();
+
   // Set the external filter to the pass freq
   extfilt.set_sampling_parameter (pass_freq);
+  side_extfilt.set_sampling_parameter (pass_freq);
   clock_frequency = clock_freq;
   sampling = method;
 
   cycles_per_sample =
     cycle_count(clock_freq/sample_freq*(1 << FIXP_SHIFT) + 0.5);
+  cycles_per_subsample =
+    cycle_count(clock_freq/(sample_freq*FIR_RES)*(1 << FIXP_SHIFT) + 0.5);
+
+  // The FIR table has unity gain, the filter scaling is applied to the
+  // convolution result (10 bits fixpoint).
+  fir_scale = int(filter_scale*(1 << 10) + 0.5);
 
   sample_offset = 0;
   sample_prev = 0;
 
+  // Clear sample buffer.
+  for (int j = 0; j < RINGSIZE*2; j++) {
+    sample[j] = 0;
+    side_sample[j] = 0;
+  }
+  sample_index = 0;
+  subsample_index = 0;
+  subsample_sum = 0;
+  subsample_count = 0;
+
   return true;
 }
 
@@ -524,10 +718,15 @@ bool SID::set_sampling_parameters(float clock_freq, sampling_method method,
 // that any adjustment of the sampling frequency will change the
 // characteristics of the resampling filter, since the filter is not rebuilt.
 // ----------------------------------------------------------------------------
-void SID::adjust_sampling_frequency(float sample_freq)
+template<chip_model model>
+void SIDChip<model>::adjust_sampling_frequency(float sample_freq)
 {
+  wake();
+
   cycles_per_sample =
     cycle_count(clock_frequency/sample_freq*(1 << FIXP_SHIFT) + 0.5);
+  cycles_per_subsample =
+    cycle_count(clock_frequency/(sample_freq*FIR_RES)*(1 << FIXP_SHIFT) + 0.5);
 }
 
 
@@ -555,8 +754,15 @@ PointPlotter<sound_sample> SID::fc_plotter()
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
 // ----------------------------------------------------------------------------
-void SID::clock()
+template<chip_model model>
+void SIDChip<model>::clock()
 {
+  if (idle) {
+    if (++idle_cycles >= 0x8000) {
+      catch_up();
+    }
+    return;
+  }
 
   // Age bus value.
   if (--bus_value_ttl <= 0) {
@@ -590,14 +796,44 @@ void SID::clock()
 // ----------------------------------------------------------------------------
 // SID clocking - delta_t cycles.
 // ----------------------------------------------------------------------------
-void SID::clock(cycle_count delta_t)
+template<chip_model model>
+void SIDChip<model>::clock(cycle_count delta_t)
 {
-  int i;
-
   if (delta_t <= 0) {
     return;
   }
 
+  if (idle) {
+    if (delta_t <= idle_delta_t) {
+      idle_cycles += delta_t;
+      if (idle_cycles >= 0x8000) {
+	catch_up();
+      }
+      return;
+    }
+    wake();
+  }
+
+  clock_voices(delta_t);
+
+  // Clock filter.
+  filter.clock(delta_t,
+	       voice[0].output(), voice[1].output(), voice[2].output(), ext_in);
+
+  // Clock external filter.
+  extfilt.clock(delta_t, filter.output());
+}
+
+
+// ----------------------------------------------------------------------------
+// SID clocking of the envelopes and oscillators - delta_t cycles.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+void SIDChip<model>::clock_voices(cycle_count delta_t)
+{
+  int i;
+
   // Age bus value.
   bus_value_ttl -= delta_t;
   if (bus_value_ttl <= 0) {
@@ -621,7 +857,7 @@ void SID::clock(cycle_count delta_t)
     // We have to clock on each MSB on / MSB off for hard sync to operate
     // correctly.
     for (i = 0; i < 3; i++) {
-      WaveformGenerator& wave = voice[i].wave;
+      WaveformGenerator<model>& wave = voice[i].wave;
 
       // It is only necessary to clock on the MSB of an oscillator that is
       // a sync source and has freq != 0.
@@ -659,13 +895,69 @@ void SID::clock(cycle_count delta_t)
 
     delta_t_osc -= delta_t_min;
   }
+}
 
-  // Clock filter.
-  filter.clock(delta_t,
-	       voice[0].output(), voice[1].output(), voice[2].output(), ext_in);
 
-  // Clock external filter.
-  extfilt.clock(delta_t, filter.output());
+// ----------------------------------------------------------------------------
+// Check for the idle state.
+// The voice outputs are constant while all envelopes are frozen at zero, so
+// once the filters have settled on them the chip output stays constant.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+bool SIDChip<model>::steady()
+{
+  for (int i = 0; i < 3; i++) {
+    EnvelopeGenerator& envelope = voice[i].envelope;
+    if (!envelope.hold_zero || envelope.envelope_counter) {
+      return false;
+    }
+  }
+
+  // Longest delta step taken by the sampling method, the interpolating
+  // methods clock one cycle at a time.
+  switch (sampling) {
+  default:
+  case SAMPLE_FAST:
+    idle_delta_t = (cycles_per_sample >> FIXP_SHIFT) + 1;
+    break;
+  case SAMPLE_RESAMPLE_FAST:
+    idle_delta_t = (cycles_per_subsample >> FIXP_SHIFT) + 1;
+    break;
+  case SAMPLE_INTERPOLATE:
+  case SAMPLE_RESAMPLE_INTERPOLATE:
+    idle_delta_t = 1;
+    break;
+  }
+
+  return filter.settled(idle_delta_t)
+    && extfilt.settled(idle_delta_t, filter.output());
+}
+
+
+// ----------------------------------------------------------------------------
+// Bring the envelopes and oscillators up to date with the idle cycles.
+// The cycles are clocked in chunks, since the accumulator delta of an
+// oscillator is the product of the cycle count and its frequency.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+void SIDChip<model>::catch_up()
+{
+  while (idle_cycles) {
+    cycle_count delta_t = idle_cycles < 0x8000 ? idle_cycles : 0x8000;
+    clock_voices(delta_t);
+    idle_cycles -= delta_t;
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+// Leave the idle state, called before anything that may change the output.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+void SIDChip<model>::wake()
+{
+  catch_up();
+  idle = false;
 }
 
 
@@ -683,22 +975,68 @@ void SID::clock(cycle_count delta_t)
 // }
 // 
 // ----------------------------------------------------------------------------
-int SID::clock(cycle_count& delta_t, short* buf, int n)
+template<chip_model model>
+int SIDChip<model>::clock(cycle_count& delta_t, short* buf, int n)
+{
+  if (capture) {
+    return clock_block<TAP_VOICES>(delta_t, buf, 0, n);
+  }
+  return clock_block<0>(delta_t, buf, 0, n);
+}
+
+// ----------------------------------------------------------------------------
+// SID clocking with audio sampling and a side channel for the panned voices.
+// buf gets the same samples as above, side the panned part of each sample.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+int SIDChip<model>::clock(cycle_count& delta_t, short* buf, short* side, int n)
 {
+  if (capture) {
+    return clock_block<TAP_SIDE | TAP_VOICES>(delta_t, buf, side, n);
+  }
+  return clock_block<TAP_SIDE>(delta_t, buf, side, n);
+}
+
+template<chip_model model>
+template<int taps>
+int SIDChip<model>::clock_block(cycle_count& delta_t, short* buf, short* side, int n)
+{
+  cycle_count delta_t_start = delta_t;
+  int s;
+
   switch (sampling) {
   default:
   case SAMPLE_FAST:
-    return clock_fast(delta_t, buf, n);
+    s = clock_fast<taps>(delta_t, buf, side, n);
+    break;
   case SAMPLE_INTERPOLATE:
-    return clock_interpolate(delta_t, buf, n);
+    s = clock_interpolate<taps>(delta_t, buf, side, n);
+    break;
+  case SAMPLE_RESAMPLE_INTERPOLATE:
+    s = clock_resample_interpolate<taps>(delta_t, buf, side, n);
+    break;
+  case SAMPLE_RESAMPLE_FAST:
+    s = clock_resample_fast<taps>(delta_t, buf, side, n);
+    break;
+  }
+
+  // The filter state only reflects the current registers once the chip has
+  // been clocked after the last write.
+  if (!idle && delta_t < delta_t_start && steady()) {
+    idle = true;
+    idle_samples = 0;
   }
+
+  return s;
 }
 
 // ----------------------------------------------------------------------------
 // SID clocking with audio sampling - delta clocking picking nearest sample.
 // ----------------------------------------------------------------------------
+template<chip_model model>
+template<int taps>
 RESID_INLINE
-int SID::clock_fast(cycle_count& delta_t, short* buf, int n)
+int SIDChip<model>::clock_fast(cycle_count& delta_t, short* buf, short* side, int n)
 {
   int s = 0;
 
@@ -714,6 +1052,12 @@ int SID::clock_fast(cycle_count& delta_t, short* buf, int n)
     clock(delta_t_sample);
     delta_t -= delta_t_sample;
     sample_offset = (next_sample_offset & FIXP_MASK) - (1 << (FIXP_SHIFT - 1));
+    if (taps & TAP_SIDE) {
+      side[s] = side_output(delta_t_sample);
+    }
+    if (taps & TAP_VOICES) {
+      capture_voices();
+    }
     buf[s++] = output();
   }
 
@@ -733,8 +1077,10 @@ int SID::clock_fast(cycle_count& delta_t, short* buf, int n)
 // external filter attenuates frequencies above 16kHz, thus reducing
 // sampling noise.
 // ----------------------------------------------------------------------------
+template<chip_model model>
+template<int taps>
 RESID_INLINE
-int SID::clock_interpolate(cycle_count& delta_t, short* buf, int n)
+int SIDChip<model>::clock_interpolate(cycle_count& delta_t, short* buf, short* side, int n)
 {
 
   int s = 0;
@@ -761,6 +1107,12 @@ int SID::clock_interpolate(cycle_count& delta_t, short* buf, int n)
     sample_offset = next_sample_offset & FIXP_MASK;
 
     short sample_now = output();
+    if (taps & TAP_SIDE) {
+      side[s] = side_output(delta_t_sample);
+    }
+    if (taps & TAP_VOICES) {
+      capture_voices();
+    }
     buf[s++] =
       sample_prev + (sample_offset*(sample_now - sample_prev) >> FIXP_SHIFT);
     sample_prev = sample_now;
@@ -780,4 +1132,200 @@ int SID::clock_interpolate(cycle_count& delta_t, short* buf, int n)
 }
 
 
+// ----------------------------------------------------------------------------
+// SID clocking with audio sampling - cycle based with audio resampling.
+//
+// This is the theoretically correct (and computationally intensive) audio
+// sample generation. The chip is clocked every cycle, and each of the
+// FIR_RES points per output sample is the mean of the cycles it covers.
+// The mean acts as a first anti-aliasing stage with zeros at the multiples
+// of the oversampled frequency, the FIR filter then removes everything above
+// the passband before decimating to the output sample frequency.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+template<int taps>
+RESID_INLINE
+int SIDChip<model>::clock_resample_interpolate(cycle_count& delta_t, short* buf, short* side, int n)
+{
+  int s = 0;
+
+  for (;;) {
+    cycle_count next_sample_offset = sample_offset + cycles_per_subsample;
+    cycle_count delta_t_sample = next_sample_offset >> FIXP_SHIFT;
+    if (delta_t_sample > delta_t) {
+      break;
+    }
+    if (subsample_index == FIR_RES - 1 && s >= n) {
+      return s;
+    }
+    for (int i = 0; i < delta_t_sample; i++) {
+      clock();
+      subsample_sum += output();
+    }
+    subsample_count += delta_t_sample;
+
+    delta_t -= delta_t_sample;
+    sample_offset = next_sample_offset & FIXP_MASK;
+
+    if (taps & TAP_SIDE) {
+      side_sample[sample_index] = side_sample[sample_index + RINGSIZE] =
+        side_output(delta_t_sample);
+    }
+    resample_push(subsample_sum/subsample_count);
+    subsample_sum = 0;
+    subsample_count = 0;
+
+    if (++subsample_index == FIR_RES) {
+      subsample_index = 0;
+      if (taps & TAP_SIDE) {
+        side[s] = fir_output(side_sample);
+      }
+      if (taps & TAP_VOICES) {
+        capture_voices();
+      }
+      buf[s++] = resample_output();
+    }
+  }
+
+  for (int i = 0; i < delta_t; i++) {
+    clock();
+    subsample_sum += output();
+  }
+  subsample_count += delta_t;
+
+  sample_offset -= delta_t << FIXP_SHIFT;
+  delta_t = 0;
+  return s;
+}
+
+
+// ----------------------------------------------------------------------------
+// SID clocking with audio sampling - delta clocking with audio resampling.
+//
+// The chip is delta clocked to the nearest cycle of each of the FIR_RES
+// points per output sample, which are then decimated by the FIR filter.
+// Aliasing from above twice the oversampled frequency is not removed, but
+// the cost is only a few delta clocks and one convolution per sample.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+template<int taps>
+RESID_INLINE
+int SIDChip<model>::clock_resample_fast(cycle_count& delta_t, short* buf, short* side, int n)
+{
+  int s = 0;
+
+  for (;;) {
+    cycle_count next_sample_offset = sample_offset + cycles_per_subsample + (1 << (FIXP_SHIFT - 1));
+    cycle_count delta_t_sample = next_sample_offset >> FIXP_SHIFT;
+    if (delta_t_sample > delta_t) {
+      break;
+    }
+    if (subsample_index == FIR_RES - 1 && s >= n) {
+      return s;
+    }
+    clock(delta_t_sample);
+    delta_t -= delta_t_sample;
+    sample_offset = (next_sample_offset & FIXP_MASK) - (1 << (FIXP_SHIFT - 1));
+
+    if (taps & TAP_SIDE) {
+      side_sample[sample_index] = side_sample[sample_index + RINGSIZE] =
+        side_output(delta_t_sample);
+    }
+    resample_push(output());
+
+    if (++subsample_index == FIR_RES) {
+      subsample_index = 0;
+      if (taps & TAP_SIDE) {
+        side[s] = fir_output(side_sample);
+      }
+      if (taps & TAP_VOICES) {
+        capture_voices();
+      }
+      buf[s++] = resample_output();
+    }
+  }
+
+  clock(delta_t);
+  sample_offset -= delta_t << FIXP_SHIFT;
+  delta_t = 0;
+  return s;
+}
+
+
+// ----------------------------------------------------------------------------
+// Store an oversampled point in the ring buffer.
+// Each point is stored twice, so that the last FIR_N*FIR_RES points can
+// always be read as one contiguous block.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+void SIDChip<model>::resample_push(short sample_now)
+{
+  sample[sample_index] = sample[sample_index + RINGSIZE] = sample_now;
+  ++sample_index;
+  sample_index &= RINGSIZE - 1;
+}
+
+
+// ----------------------------------------------------------------------------
+// Convolution of the last FIR_N*FIR_RES points with the filter impulse
+// response.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+short SIDChip<model>::resample_output()
+{
+  // While idle, only the constant output is pushed to the ring buffer. Once
+  // it spans the impulse response, the convolution result is constant too.
+  if (idle) {
+    if (idle_samples > FIR_N) {
+      return idle_sample;
+    }
+    ++idle_samples;
+  }
+
+  idle_sample = fir_output(sample);
+  return idle_sample;
+}
+
+
+// ----------------------------------------------------------------------------
+// Convolution of the last FIR_N*FIR_RES points of a ring buffer, sample or
+// side_sample, with the filter impulse response.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+RESID_INLINE
+short SIDChip<model>::fir_output(const short* ring)
+{
+  const int fir_length = FIR_N*FIR_RES;
+  const short* sample_start = ring + sample_index + RINGSIZE - fir_length;
+  const short* sample_end = sample_start + fir_length - 1;
+
+  // The impulse response is symmetric, so the points are folded pairwise
+  // to halve the number of multiplications. The absolute taps add up to
+  // more than 2^16, full scale input would overflow a 32 bit sum. All taps
+  // but the center pair add up to less than 2^15, so they are summed in 32
+  // bits and the center pair is added in 64 bits.
+  const int center = fir_length/2 - 1;
+  int v = 0;
+  for (int j = 0; j < center; j++) {
+    v += (sample_start[j] + sample_end[-j])*fir_table[j];
+  }
+  int64_t sum = v + int64_t(sample_start[center] + sample_end[-center])*fir_table[center];
+
+  v = int(sum >> FIR_SHIFT)*fir_scale >> 10;
+
+  // Saturated arithmetics to guard against 16 bit sample overflow.
+  const int half = 1 << 15;
+  if (v >= half) {
+    v = half - 1;
+  }
+  else if (v < -half) {
+    v = -half;
+  }
+
+  return v;
+}
+
+
 RESID_NAMESPACE_STOP
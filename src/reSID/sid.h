@@ -25,35 +25,65 @@
 #include "filter.h"
 #include "extfilt.h"
 #include "pot.h"
+#include "firtable.h"
 
 RESID_NAMESPACE_START
 
+// ----------------------------------------------------------------------------
+// Per voice sample buffers for scopes and meters, see SID::set_voice_capture.
+// The block clock stores every decimation'th sample of each voice with a
+// buffer at buf[length] and advances length, until size samples are stored.
+// The samples are waveform x envelope before the filter, scaled to 16 bits.
+// ----------------------------------------------------------------------------
+struct VoiceCapture
+{
+  short* buf[3];
+  int size;
+  int length;
+  int decimation;
+  int phase;
+
+  VoiceCapture() : size(0), length(0), decimation(1), phase(0)
+  {
+    buf[0] = buf[1] = buf[2] = 0;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Block level interface to a SID chip.
+// The chip model is a template parameter of SIDChip below, this base class
+// lets the players and sketches handle either model through one pointer.
+// The per cycle engine is not virtual, so only the calls made once per
+// register write or sample block go through the vtable.
+// ----------------------------------------------------------------------------
 class SID
 {
 public:
-  SID();
-  ~SID();
-	//void printFilter(void);
-  //void set_chip_model(chip_model model);
-  void enable_filter(bool enable);
-  void enable_external_filter(bool enable);
-  bool set_sampling_parameters(float clock_freq, sampling_method method,
-			       float sample_freq, float pass_freq = -1,
-			       float filter_scale = 0.97);
-  void adjust_sampling_frequency(float sample_freq);
+  virtual ~SID() {}
 
-  //void fc_default(const fc_point*& points, int& count);
-  //PointPlotter<sound_sample> fc_plotter();
+  virtual chip_model get_chip_model() = 0;
+  virtual void enable_filter(bool enable) = 0;
+  virtual void enable_external_filter(bool enable) = 0;
+  virtual bool set_sampling_parameters(float clock_freq,
+				       sampling_method method,
+				       float sample_freq, float pass_freq = -1,
+				       float filter_scale = 0.97) = 0;
+  virtual void adjust_sampling_frequency(float sample_freq) = 0;
 
-  void clock();
-  void clock(cycle_count delta_t);
-  int clock(cycle_count& delta_t, short* buf, int n);
-  void reset();
+  virtual void clock() = 0;
+  virtual void clock(cycle_count delta_t) = 0;
+  virtual int clock(cycle_count& delta_t, short* buf, int n) = 0;
+  // Block clock with a side channel for stereo panning, see set_voice_pan().
+  virtual int clock(cycle_count& delta_t, short* buf, short* side, int n) = 0;
+  virtual void reset() = 0;
   
   // Read/write registers.
-  reg8 read(reg8 offset);
-  void write(reg8 offset, reg8 value);
-  void mute(reg8 channel, bool enable);
+  virtual reg8 read(reg8 offset) = 0;
+  virtual void write(reg8 offset, reg8 value) = 0;
+  // Write registers $00-$18 from a register dump, only the registers that
+  // differ from the last written values are dispatched.
+  virtual void write_block(const uint8_t* regs) = 0;
+  virtual void mute(reg8 channel, bool enable) = 0;
 
   // Read/write state.
   class State
@@ -77,6 +107,70 @@ public:
     bool hold_zero[3];
   };
     
+  virtual State read_state() = 0;
+  virtual void write_state(const State& state) = 0;
+
+  // 16-bit input (EXT IN).
+  virtual void input(int sample) = 0;
+
+  // 16-bit output (AUDIO OUT).
+  virtual int output() = 0;
+  // n-bit output.
+  virtual int output(int bits) = 0;
+  // Per-voice amplitude-modulated output (waveform x envelope, pre-filter).
+  // Call after clock() while state is current.
+  virtual sound_sample voice_output(int i) = 0;
+
+  // Stereo placement of voice i, -32768 is left, 0 centered, 32767 right.
+  // The panned voices are rendered to a side channel, left = buf + side and
+  // right = buf - side. Voices routed through the filter stay centered.
+  // The side channel goes through its own external filter and, with the
+  // SAMPLE_RESAMPLE_* methods, the same FIR as buf, so both stay aligned.
+  virtual void set_voice_pan(int i, int pan) = 0;
+  virtual bool voice_panned() = 0;
+
+  // Fill the buffers of capture in the block clocks, in the same pass as
+  // the mixed output. Pass 0 to stop capturing.
+  virtual void set_voice_capture(VoiceCapture* capture) = 0;
+};
+
+
+// ----------------------------------------------------------------------------
+// SID chip emulation, MOS6581 or MOS8580.
+// The class is final, so the calls from the sampling loops to clock() and
+// output() are resolved at compile time.
+// ----------------------------------------------------------------------------
+template<chip_model model>
+class SIDChip final : public SID
+{
+public:
+  SIDChip();
+  ~SIDChip();
+	//void printFilter(void);
+  chip_model get_chip_model() { return model; }
+  void enable_filter(bool enable);
+  void enable_external_filter(bool enable);
+  bool set_sampling_parameters(float clock_freq, sampling_method method,
+			       float sample_freq, float pass_freq = -1,
+			       float filter_scale = 0.97);
+  void adjust_sampling_frequency(float sample_freq);
+
+  //void fc_default(const fc_point*& points, int& count);
+  //PointPlotter<sound_sample> fc_plotter();
+
+  void clock();
+  void clock(cycle_count delta_t);
+  int clock(cycle_count& delta_t, short* buf, int n);
+  int clock(cycle_count& delta_t, short* buf, short* side, int n);
+  void reset();
+  
+  // Read/write registers.
+  reg8 read(reg8 offset);
+  void write(reg8 offset, reg8 value);
+  void write_block(const uint8_t* regs);
+  void mute(reg8 channel, bool enable);
+
+  // Read/write state.
   State read_state();
   void write_state(const State& state);
 
@@ -90,31 +184,84 @@ public:
   // Per-voice amplitude-modulated output (waveform x envelope, pre-filter).
   // Call after clock() while state is current.
   sound_sample voice_output(int i) { return voice[i].output(); }
+
+  void set_voice_pan(int i, int pan);
+  bool voice_panned() { return voice_pan[0] | voice_pan[1] | voice_pan[2]; }
+
+  void set_voice_capture(VoiceCapture* capture) { this->capture = capture; }
 protected:
 
-  RESID_INLINE int clock_fast(cycle_count& delta_t, short* buf, int n);
-  RESID_INLINE int clock_interpolate(cycle_count& delta_t, short* buf, int n);
+  RESID_INLINE void clock_voices(cycle_count delta_t);
+  bool steady();
+  void catch_up();
+  void wake();
 
-	Voice voice[3];
-  SidFilter filter;
-  ExternalFilter extfilt;
+  // The taps parameter selects the loops that also fill the side channel or
+  // the voice buffers, so the plain loops are unchanged.
+  enum { TAP_SIDE = 1, TAP_VOICES = 2 };
+
+  template<int taps>
+  int clock_block(cycle_count& delta_t, short* buf, short* side, int n);
+  template<int taps>
+  RESID_INLINE int clock_fast(cycle_count& delta_t, short* buf, short* side,
+			      int n);
+  template<int taps>
+  RESID_INLINE int clock_interpolate(cycle_count& delta_t, short* buf,
+				     short* side, int n);
+  template<int taps>
+  RESID_INLINE int clock_resample_interpolate(cycle_count& delta_t, short* buf,
+					      short* side, int n);
+  template<int taps>
+  RESID_INLINE int clock_resample_fast(cycle_count& delta_t, short* buf,
+				       short* side, int n);
+  RESID_INLINE int voice_tap(int i);
+  RESID_INLINE short side_output(cycle_count delta_t);
+  RESID_INLINE void capture_voices();
+  RESID_INLINE void resample_push(short sample);
+  RESID_INLINE short resample_output();
+  RESID_INLINE short fir_output(const short* ring);
+
+	Voice<model> voice[3];
+  SidFilter<model> filter;
+  ExternalFilter<model> extfilt;
+  ExternalFilter<model> side_extfilt;
   Potentiometer potx;
   Potentiometer poty;
 
   reg8 bus_value;
   cycle_count bus_value_ttl;
 
+  // Last values written to the write only registers.
+  reg8 shadow_register[0x19];
+
   float clock_frequency;
 
   // External audio input.
   int ext_in;
 
+  // Stereo placement of the voices.
+  int voice_pan[3];
+
+  // Per voice sample buffers, or 0.
+  VoiceCapture* capture;
+
+  // Idle state.
+  // When the envelopes are frozen at zero and the filters have settled, the
+  // output is constant until the next register write. The filters are then
+  // not clocked, and the oscillators and envelopes are caught up in bulk.
+  // The filters are only known to be settled for the step lengths of the
+  // current sampling method, up to idle_delta_t cycles.
+  bool idle;
+  cycle_count idle_delta_t;
+  cycle_count idle_cycles;
+  int idle_samples;
+  short idle_sample;
+
   // Resampling constants.
   static const int FIR_N;
-  static const int FIR_RES_INTERPOLATE;
-  static const int FIR_RES_FAST;
+  static const int FIR_RES;
   static const int FIR_SHIFT;
-  static const int RINGSIZE;
+  static const int RINGSIZE = 512;
 
   // Fixpoint constants.
   static const int FIXP_SHIFT;
@@ -126,11 +273,22 @@ protected:
   cycle_count sample_offset;
   int sample_index;
   short sample_prev;
-  int fir_N;
-  int fir_RES;
+
+  // Resampling variables.
+  cycle_count cycles_per_subsample;
+  int subsample_index;
+  int subsample_sum;
+  int subsample_count;
+  int fir_scale;
+  short sample[RINGSIZE*2];
+  // The side channel at the same points, for the panned voices.
+  short side_sample[RINGSIZE*2];
 
 };
 
+typedef SIDChip<MOS6581> SID6581;
+typedef SIDChip<MOS8580> SID8580;
+
 RESID_NAMESPACE_STOP
 
 #endif // not __SID_H__
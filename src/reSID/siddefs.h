@@ -27,6 +27,15 @@
 #define RESID_INLINING 1
 #define RESID_INLINE inline
 
+// Skip-ahead clocking on/off.
+// Delta clocking jumps directly over envelope periods where the envelope
+// counter is frozen, and shifts the noise register several bits at a time.
+// The output is identical either way; define as 0 before including
+// SidTools.h to step through every event as the original reSID does.
+#ifndef RESID_SKIP_AHEAD
+#define RESID_SKIP_AHEAD 1
+#endif
+
 // Support namespace
 //#define RESID_NAMESPACE
 
@@ -67,9 +76,10 @@ typedef int cycle_count;
 typedef int sound_sample;
 typedef sound_sample fc_point[2];
 
-//enum chip_model { MOS6581, MOS8580 };
+enum chip_model { MOS6581, MOS8580 };
 
-enum sampling_method { SAMPLE_FAST, SAMPLE_INTERPOLATE};
+enum sampling_method { SAMPLE_FAST, SAMPLE_INTERPOLATE,
+		       SAMPLE_RESAMPLE_INTERPOLATE, SAMPLE_RESAMPLE_FAST };
 
 extern "C"
 {
@@ -26,12 +26,12 @@
 
 RESID_NAMESPACE_START
 
+template<chip_model model>
 class Voice
 {
 public:
   Voice();
 
-//  void set_chip_model(chip_model model);
   void set_sync_source(Voice*);
   void reset();
   void mute(bool enable);
@@ -43,17 +43,18 @@ public:
   RESID_INLINE sound_sample output();
 
 protected:
-  WaveformGenerator wave;
+  WaveformGenerator<model> wave;
   EnvelopeGenerator envelope;
   bool muted;
 
   // Waveform D/A zero level.
-  sound_sample wave_zero;
+  // See voice.cc for the MOS6581 measurements, the MOS8580 has no DC offsets.
+  static const sound_sample wave_zero = model == MOS6581 ? 0x380 : 0x800;
 
   // Multiplying D/A DC offset.
-  sound_sample voice_DC;
+  static const sound_sample voice_DC = model == MOS6581 ? 0x800*0xff : 0;
 
-friend class SID;
+template<chip_model> friend class SIDChip;
 };
 
 
@@ -69,8 +70,9 @@ friend class SID;
 // Amplitude modulated waveform output.
 // Ideal range [-2048*255, 2047*255].
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-sound_sample Voice::output()
+sound_sample Voice<model>::output()
 {
   if (!muted)
   { // Multiply oscillator output with envelope output.
@@ -25,17 +25,11 @@ RESID_NAMESPACE_START
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
-WaveformGenerator::WaveformGenerator()
+template<chip_model model>
+WaveformGenerator<model>::WaveformGenerator()
 {
   sync_source = this;
 
- // set_chip_model(MOS6581);
- {//instead:
-	wave__ST = &wave6581__ST[0];
-  wave_P_T = &wave6581_P_T[0];
-  wave_PS_ = &wave6581_PS_[0];
-  wave_PST = &wave6581_PST[0];
- }
   reset();
 }
 
@@ -43,58 +37,43 @@ WaveformGenerator::WaveformGenerator()
 // ----------------------------------------------------------------------------
 // Set sync source.
 // ----------------------------------------------------------------------------
-void WaveformGenerator::set_sync_source(WaveformGenerator* source)
+template<chip_model model>
+void WaveformGenerator<model>::set_sync_source(WaveformGenerator* source)
 {
   sync_source = source;
   source->sync_dest = this;
 }
 
 
-// ----------------------------------------------------------------------------
-// Set chip model.
-// ----------------------------------------------------------------------------
-/*
-void WaveformGenerator::set_chip_model(chip_model model)
-{
-  if (model == MOS6581) {
-    wave__ST = &wave6581__ST[0];
-    wave_P_T = &wave6581_P_T[0];
-    wave_PS_ = &wave6581_PS_[0];
-    wave_PST = &wave6581_PST[0];
-  } 
-  else {
-    wave__ST = &wave8580__ST[0];
-    wave_P_T = &wave8580_P_T[0];
-    wave_PS_ = &wave8580_PS_[0];
-    wave_PST = &wave8580_PST[0];
-  }
-}
-*/
-
 // ----------------------------------------------------------------------------
 // Register functions.
 // ----------------------------------------------------------------------------
-void WaveformGenerator::writeFREQ_LO(reg8 freq_lo)
+template<chip_model model>
+void WaveformGenerator<model>::writeFREQ_LO(reg8 freq_lo)
 {
   freq = (freq & 0xff00) | (freq_lo & 0x00ff);
 }
 
-void WaveformGenerator::writeFREQ_HI(reg8 freq_hi)
+template<chip_model model>
+void WaveformGenerator<model>::writeFREQ_HI(reg8 freq_hi)
 {
   freq = (((unsigned int) freq_hi << 8) & 0xff00) | (freq & 0x00ff);
 }
 
-void WaveformGenerator::writePW_LO(reg8 pw_lo)
+template<chip_model model>
+void WaveformGenerator<model>::writePW_LO(reg8 pw_lo)
 {
   pw = (pw & 0xf00) | (pw_lo & 0x0ff);
 }
 
-void WaveformGenerator::writePW_HI(reg8 pw_hi)
+template<chip_model model>
+void WaveformGenerator<model>::writePW_HI(reg8 pw_hi)
 {
   pw = (((unsigned int)pw_hi << 8) & 0xf00) | (pw & 0x0ff);
 }
 
-void WaveformGenerator::writeCONTROL_REG(reg8 control)
+template<chip_model model>
+void WaveformGenerator<model>::writeCONTROL_REG(reg8 control)
 {
   waveform = (control >> 4) & 0x0f;
   ring_mod = control & 0x04;
@@ -129,7 +108,8 @@ void WaveformGenerator::writeCONTROL_REG(reg8 control)
   // The gate bit is handled by the EnvelopeGenerator.
 }
 
-reg8 WaveformGenerator::readOSC()
+template<chip_model model>
+reg8 WaveformGenerator<model>::readOSC()
 {
   return output() >> 4;
 }
@@ -137,7 +117,8 @@ reg8 WaveformGenerator::readOSC()
 // ----------------------------------------------------------------------------
 // SID reset.
 // ----------------------------------------------------------------------------
-void WaveformGenerator::reset()
+template<chip_model model>
+void WaveformGenerator<model>::reset()
 {
   accumulator = 0;
   shift_register = 0x7ffff8;
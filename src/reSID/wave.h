@@ -27,6 +27,10 @@
 #include "wave6581_P_T.h"
 #include "wave6581_PST.h"
 #include "wave6581_PS_.h"
+#include "wave8580__ST.h"
+#include "wave8580_P_T.h"
+#include "wave8580_PST.h"
+#include "wave8580_PS_.h"
 
 RESID_NAMESPACE_START
 
@@ -37,14 +41,17 @@ RESID_NAMESPACE_START
 // when TEST is cleared.
 // The noise waveform is taken from intermediate bits of a 23 bit shift
 // register. This register is clocked by bit 19 of the accumulator.
+//
+// The chip model is a template parameter, so that the combined waveform
+// tables are resolved at compile time.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 class WaveformGenerator
 {
 public:
   WaveformGenerator();
 
   void set_sync_source(WaveformGenerator*);
-  //void set_chip_model(chip_model model);
 
   RESID_INLINE void clock();
   RESID_INLINE void clock(cycle_count delta_t);
@@ -105,29 +112,17 @@ protected:
   RESID_INLINE reg12 outputNPST();
 
   // Sample data for combinations of waveforms.
-  // static reg8 wave6581__ST[];
-  // static reg8 wave6581_P_T[];
-  // static reg8 wave6581_PS_[];
-  // static reg8 wave6581_PST[];
-
-  // static reg8 wave8580__ST[];
-  // static reg8 wave8580_P_T[];
-  // static reg8 wave8580_PS_[];
-  // static reg8 wave8580_PST[];
-
-  // reg8* wave__ST;
-  // reg8* wave_P_T;
-  // reg8* wave_PS_;
-  // reg8* wave_PST;
-
-
-  const reg8* wave__ST;
-  const reg8* wave_P_T;
-  const reg8* wave_PS_;
-  const reg8* wave_PST;
-
-friend class Voice;
-friend class SID;
+  static constexpr const reg8* wave__ST =
+    model == MOS6581 ? wave6581__ST : wave8580__ST;
+  static constexpr const reg8* wave_P_T =
+    model == MOS6581 ? wave6581_P_T : wave8580_P_T;
+  static constexpr const reg8* wave_PS_ =
+    model == MOS6581 ? wave6581_PS_ : wave8580_PS_;
+  static constexpr const reg8* wave_PST =
+    model == MOS6581 ? wave6581_PST : wave8580_PST;
+
+template<chip_model> friend class Voice;
+template<chip_model> friend class SIDChip;
 };
 
 
@@ -142,8 +137,9 @@ friend class SID;
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void WaveformGenerator::clock()
+void WaveformGenerator<model>::clock()
 {
   // No operation if test bit is set.
   if (test) {
@@ -171,8 +167,9 @@ void WaveformGenerator::clock()
 // ----------------------------------------------------------------------------
 // SID clocking - delta_t cycles.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void WaveformGenerator::clock(cycle_count delta_t)
+void WaveformGenerator<model>::clock(cycle_count delta_t)
 {
   // No operation if test bit is set.
   if (test) {
@@ -191,6 +188,24 @@ void WaveformGenerator::clock(cycle_count delta_t)
 
   // Shift noise register once for each time accumulator bit 19 is set high.
   // Bit 19 is set high each time 2^20 (0x100000) is added to the accumulator.
+#if RESID_SKIP_AHEAD
+  // Count the bit 19 rising edges directly; offsetting by 2^19 turns them
+  // into multiples of 2^20.
+  reg24 shifts = ((accumulator_prev + 0x080000 + delta_accumulator) >> 20)
+    - ((accumulator_prev + 0x080000) >> 20);
+
+  // The feedback taps are bits 22 and 17, so up to 18 new bits only depend
+  // on bits already in the register and can be shifted in at once.
+  while (shifts) {
+    reg24 n = shifts < 18 ? shifts : 18;
+    reg24 bits = ((shift_register >> (23 - n)) ^ (shift_register >> (18 - n)))
+      & ((1 << n) - 1);
+    shift_register <<= n;
+    shift_register &= 0x7fffff;
+    shift_register |= bits;
+    shifts -= n;
+  }
+#else
   reg24 shift_period = 0x100000;
 
   while (delta_accumulator) {
@@ -223,6 +238,7 @@ void WaveformGenerator::clock(cycle_count delta_t)
 
     delta_accumulator -= shift_period;
   }
+#endif
 }
 
 
@@ -233,8 +249,9 @@ void WaveformGenerator::clock(cycle_count delta_t)
 // Note that the oscillators must be clocked exactly on the cycle when the
 // MSB is set high for hard sync to operate correctly. See SID::clock().
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-void WaveformGenerator::synchronize()
+void WaveformGenerator<model>::synchronize()
 {
   // A special case occurs when a sync source is synced itself on the same
   // cycle as when its MSB is set high. In this case the destination will
@@ -254,8 +271,9 @@ void WaveformGenerator::synchronize()
 // No waveform:
 // Zero output.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output____()
+reg12 WaveformGenerator<model>::output____()
 {
   return 0x000;
 }
@@ -267,8 +285,9 @@ reg12 WaveformGenerator::output____()
 // left-shifted (half the resolution, full amplitude).
 // Ring modulation substitutes the MSB with MSB EOR sync_source MSB.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output___T()
+reg12 WaveformGenerator<model>::output___T()
 {
   reg24 msb = (ring_mod ? accumulator ^ sync_source->accumulator : accumulator)
     & 0x800000;
@@ -278,8 +297,9 @@ reg12 WaveformGenerator::output___T()
 // Sawtooth:
 // The output is identical to the upper 12 bits of the accumulator.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output__S_()
+reg12 WaveformGenerator<model>::output__S_()
 {
   return accumulator >> 12;
 }
@@ -294,8 +314,9 @@ reg12 WaveformGenerator::output__S_()
 // The test bit, when set to one, holds the pulse waveform output at 0xfff
 // regardless of the pulse width setting.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output_P__()
+reg12 WaveformGenerator<model>::output_P__()
 {
   return (test || (accumulator >> 12) >= pw) ? 0xfff : 0x000;
 }
@@ -319,8 +340,9 @@ reg12 WaveformGenerator::output_P__()
 //
 // Since waveform output is 12 bits the output is left-shifted 4 times.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputN___()
+reg12 WaveformGenerator<model>::outputN___()
 {
   return
     ((shift_register & 0x400000) >> 11) |
@@ -391,26 +413,30 @@ reg12 WaveformGenerator::outputN___()
 // The sawtooth output is used to look up an OSC3 sample.
 // The sample is output if the pulse output is on.
 // 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output__ST()
+reg12 WaveformGenerator<model>::output__ST()
 {
   return wave__ST[output__S_()] << 4;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output_P_T()
+reg12 WaveformGenerator<model>::output_P_T()
 {
   return (wave_P_T[output___T() >> 1] << 4) & output_P__();
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output_PS_()
+reg12 WaveformGenerator<model>::output_PS_()
 {
   return (wave_PS_[output__S_()] << 4) & output_P__();
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output_PST()
+reg12 WaveformGenerator<model>::output_PST()
 {
   return (wave_PST[output__S_()] << 4) & output_P__();
 }
@@ -424,44 +450,51 @@ reg12 WaveformGenerator::output_PST()
 // there is very little audible output from waveform combinations including
 // noise. We hope that nobody is actually using it.
 //
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputN__T()
+reg12 WaveformGenerator<model>::outputN__T()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputN_S_()
+reg12 WaveformGenerator<model>::outputN_S_()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputN_ST()
+reg12 WaveformGenerator<model>::outputN_ST()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputNP__()
+reg12 WaveformGenerator<model>::outputNP__()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputNP_T()
+reg12 WaveformGenerator<model>::outputNP_T()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputNPS_()
+reg12 WaveformGenerator<model>::outputNPS_()
 {
   return 0;
 }
 
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::outputNPST()
+reg12 WaveformGenerator<model>::outputNPST()
 {
   return 0;
 }
@@ -469,8 +502,9 @@ reg12 WaveformGenerator::outputNPST()
 // ----------------------------------------------------------------------------
 // Select one of 16 possible combinations of waveforms.
 // ----------------------------------------------------------------------------
+template<chip_model model>
 RESID_INLINE
-reg12 WaveformGenerator::output()
+reg12 WaveformGenerator<model>::output()
 {
   // It may seem cleaner to use an array of member functions to return
   // waveform output; however a switch with inline functions is faster.